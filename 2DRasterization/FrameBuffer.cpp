@@ -3,14 +3,15 @@
 /**
  * Explicit Value Constructor
  *
- * @param window   The SDL_Window to render into
+ * @param window   The SDL_Window to render into (or NULL for a
+ *                 FrameBuffer that discards its pixels)
  * @param width    The width (in pixels) of the FrameBuffer
  * @param height   The height (in pixels) of the FrameBuffer
  */
 FrameBuffer::FrameBuffer(SDL_Window* window, int width, int height)
 {
    keepRunning = true;
-   renderer = SDL_CreateRenderer(window, -1, 0);
+   renderer = (window == NULL) ? NULL : SDL_CreateRenderer(window, -1, 0);
 
    this->height = height;
    this->width = width;   
@@ -28,7 +29,7 @@ FrameBuffer::FrameBuffer(SDL_Window* window, int width, int height)
  */
 FrameBuffer::~FrameBuffer()
 {
-  SDL_DestroyRenderer(renderer);   
+  if (renderer != NULL) SDL_DestroyRenderer(renderer);   
 }
 
 /**
@@ -38,6 +39,8 @@ FrameBuffer::~FrameBuffer()
  */
 void FrameBuffer::clear(const Color& color)
 {
+   if (renderer == NULL) return;
+
    SDL_SetRenderDrawColor(renderer, 
                           color.red, color.green, color.blue, 
                           255);
@@ -87,7 +90,8 @@ void FrameBuffer::setKeyboardHandler(void (*handler)(const SDL_Event& event))
  */
 void FrameBuffer::setPixel(int x, int y, const Color& color)
 {
-   if ((x >= xMin) && (x <=xMax) && (y >= yMin) & (y <= yMax))
+   if ((x >= xMin) && (x <=xMax) && (y >= yMin) & (y <= yMax) &&
+       (renderer != NULL))
    {
       SDL_SetRenderDrawColor(renderer, 
                              color.red, color.green, color.blue,
@@ -96,6 +100,29 @@ void FrameBuffer::setPixel(int x, int y, const Color& color)
    }
 }
 
+/**
+ * Set a horizontal run of pixels to a particular color (with one line,
+ * rather than n points)
+ *
+ * @param x      The horizontal coordinate of the first (leftmost) pixel
+ * @param y      The vertical coordinate of the pixels
+ * @param n      The number of pixels
+ * @param color  The Color
+ */
+void FrameBuffer::setPixels(int x, int y, int n, const Color& color)
+{
+   int first = (x < xMin) ? xMin : x;
+   int last  = (x + n - 1 > xMax) ? xMax : x + n - 1;
+
+   if ((first <= last) && (y >= yMin) && (y <= yMax) && (renderer != NULL))
+   {
+      SDL_SetRenderDrawColor(renderer, 
+                             color.red, color.green, color.blue,
+                             255);
+      SDL_RenderDrawLine(renderer, first-xMin, yMax-y, last-xMin, yMax-y);
+   }
+}
+
 /**
  * Show this FrameBuffer in the window
  */
@@ -103,6 +130,8 @@ void FrameBuffer::show()
 {
    SDL_Event       event;
    
+   if (renderer == NULL) return;
+
    SDL_RenderPresent(renderer);
    while(keepRunning)
    {
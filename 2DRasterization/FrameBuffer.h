@@ -19,7 +19,9 @@ class FrameBuffer
   /**
    * Explicit Value Constructor
    *
-   * @param window   The SDL_Window to render into
+   * @param window   The SDL_Window to render into (or NULL for a
+   *                 FrameBuffer that discards its pixels, e.g., to
+   *                 benchmark a Rasterizer without timing SDL)
    * @param width    The width (in pixels) of the FrameBuffer
    * @param height   The height (in pixels) of the FrameBuffer
    */
@@ -72,6 +74,16 @@ class FrameBuffer
    */
    void setPixel(int x, int y, const Color& color);   
 
+  /**
+   * Set a horizontal run of pixels to a particular color
+   *
+   * @param x      The horizontal coordinate of the first (leftmost) pixel
+   * @param y      The vertical coordinate of the pixels
+   * @param n      The number of pixels
+   * @param color  The Color
+   */
+   void setPixels(int x, int y, int n, const Color& color);
+
   /**
    * Show this FrameBuffer in the window
    */
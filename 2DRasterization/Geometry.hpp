@@ -10,9 +10,39 @@
 #define __GEOMETRY_HPP__
 
 
+#include <algorithm>
+#include <climits>
 #include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
 #include "../Matrix/Matrix.hpp"
 #include "../Matrix/Vector.hpp"
+#include "Predicates.hpp"
+
+// The batch coverage test of EdgeFunctions uses AVX2 or SSE2 when they
+// are available (and MATRIX_NO_SIMD isn't defined)
+#if !defined(MATRIX_NO_SIMD) && defined(__AVX2__)
+#define GEOMETRY_SIMD_AVX2
+#include <immintrin.h>
+#elif !defined(MATRIX_NO_SIMD) && defined(__SSE2__)
+#define GEOMETRY_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+// countTrailingZeros() uses std::countr_zero (C++20) when it is
+// available and otherwise the compiler's intrinsic
+#if defined(__has_include)
+#if __has_include(<bit>) && __cplusplus >= 202002L
+#include <bit>
+#endif
+#endif
+#if defined(_MSC_VER) && !defined(__cpp_lib_bitops)
+#include <intrin.h>
+#endif
 
 /**
  * A utility class (actually template) that can perform various
@@ -29,6 +59,16 @@
 
 // Note: area(), inside(), and toImplicit() are templated so that they are
 // one-to-one with Matrix
+//
+// Note: The points passed to inside(), signedArea(), testHalfspace(),
+// toImplicit() and perp() can be any 2x1 expression (e.g., a Matrix<2,1>
+// or a view of a column of a Matrix<2,N>, see MatrixView.hpp), so the
+// vertices of a polygon don't have to be copied out of it.
+//
+// Note: The sign tests (i.e., area(), signedArea(), the four point
+// testHalfspace(), inside() and intersect()) use the robust predicates
+// in Predicates.hpp, so points on (or very near) an edge are classified
+// consistently.
 
 template <int N>
 double area(const Matrix<2,1>& a, const Matrix<2,1>& b, const Matrix<2,1>& c);
@@ -41,31 +81,52 @@ Vector<N> barycentricCombination(const Matrix<N,1>& q,
 template <int R, int C>
 Matrix<R,2> getBounds(const Matrix<R,C>& p);
 
-template <int N>
-bool inside(const Matrix<2,1>& p, 
-            const Matrix<2,1>& r, const Matrix<2,1>& s, const Matrix<2,1>& t);
+template <int N, class P, class R, class S, class T>
+bool inside(const MatrixExpression<P,2,1>& p, const MatrixExpression<R,2,1>& r,
+            const MatrixExpression<S,2,1>& s, const MatrixExpression<T,2,1>& t);
 
 template <int N>
 bool intersect(const Matrix<2,1>& p, const Matrix<2,1>& q,
                const Matrix<2,1>& r, const Matrix<2,1>& s,
                double& alpha, double& beta);
 
-template <int N>
-Vector<2> perp(const Matrix<2,1>& a);
+template <int N, class A>
+Vector<2> perp(const MatrixExpression<A,2,1>& a);
 
-template <int N>
-double toImplicit(const Matrix<2,1>& p, const Matrix<2,1>& q, Matrix<2,1>* n);
+template <int N, class P, class Q>
+double toImplicit(const MatrixExpression<P,2,1>& p,
+                  const MatrixExpression<Q,2,1>& q, Matrix<2,1>* n);
+
+template <int N, class P, class R, class S>
+bool signedArea(const MatrixExpression<P,2,1>& p, 
+                const MatrixExpression<R,2,1>& r,
+                const MatrixExpression<S,2,1>& s);
+
+template <int N, class P, class R, class A, class B>
+int testHalfspace(const MatrixExpression<P,2,1>& p,
+                  const MatrixExpression<R,2,1>& r,
+                  const MatrixExpression<A,2,1>& a,
+                  const MatrixExpression<B,2,1>& b);
+
+template <int N, class P, class M>
+int testHalfspace(const MatrixExpression<P,2,1>& p,
+                  const MatrixExpression<M,2,1>& n, double b);
 
 template <int N>
-bool signedArea(const Matrix<2,1>& p, const Matrix<2,1>& r, 
-    const Matrix<2,1>& s);
+bool clipLine(Matrix<2,1>& p, Matrix<2,1>& q, const Matrix<2,2>& window);
+
+struct SegmentIntersection;
 
 template <int N>
-int testHalfspace(const Matrix<2,1>& p, const Matrix<2,1>& r,
-       const Matrix<2,1>& a, const Matrix<2,1>& b);
+std::vector<SegmentIntersection>
+intersectSegments(const std::vector< Matrix<2,2> >& segments);
 
 template <int N>
-int testHalfspace(const Matrix<2,1>& p, const Matrix<2,1>& n, double b);
+int clipPolygon(const Matrix<2,N>& polygon, const Matrix<2,2>& window,
+                Matrix<2,N+4>* clipped);
+
+template <int R>
+bool contains(const Matrix<R,2>& outer, const Matrix<R,2>& inner);
 
 /**
  * Compute the area of a triangle from its three vertices
@@ -83,19 +144,7 @@ int testHalfspace(const Matrix<2,1>& p, const Matrix<2,1>& n, double b);
 template <int N>
 double area(const Matrix<2,1>& a, const Matrix<2,1>& b, const Matrix<2,1>& c)
 {
-    Vector<2> na, nb, nc;
-    na = { 0, 0 };
-    nb = b - a;
-    nc = c - a;
-
-    Matrix<2,2> aa, bb, cc;
-    aa = na | nb ;
-    bb = nb | nc ;
-    cc = nc | na ;
-
-    double retVal = 0.5 * (det(aa) + det(bb) + det(cc));
-    
-    return retVal;
+    return 0.5 * orient2d(a, b, c);
 }
 
 
@@ -158,13 +207,13 @@ Matrix<R,2> getBounds(const Matrix<R,C>& p)
  *
  * @return true if signed area is positive, otherwise false
  */
-template <int N>
-bool signedArea(const Matrix<2,1>& p, const Matrix<2,1>& r,
-            const Matrix<2,1>& s)
+template <int N, class P, class R, class S>
+bool signedArea(const MatrixExpression<P,2,1>& p, 
+                const MatrixExpression<R,2,1>& r,
+                const MatrixExpression<S,2,1>& s)
 {
-   Matrix<2,2> rs;
-   rs = (s-r) | (p-r);
-   return (det(rs) > 0.0f) ? true : false;
+   // The determinant of (s-r) | (p-r)
+   return orient2d(r, s, p) > 0.0;
 }
 
 /** 
@@ -176,16 +225,16 @@ bool signedArea(const Matrix<2,1>& p, const Matrix<2,1>& r,
  * @param b the other point of line
  * @return 1 if p and r is same side, -1 otherwise.
  */
-template <int N>
-int testHalfspace(const Matrix<2,1>& p, const Matrix<2,1>& r, 
-        const Matrix<2,1>& a, const Matrix<2,1>& b)
+template <int N, class P, class R, class A, class B>
+int testHalfspace(const MatrixExpression<P,2,1>& p,
+                  const MatrixExpression<R,2,1>& r,
+                  const MatrixExpression<A,2,1>& a,
+                  const MatrixExpression<B,2,1>& b)
 {
-    Matrix<2,1> n,m;
-    double scalarB;
-
-    scalarB = toImplicit<2>(a,b, &n);
-    int retA = (dot(n,p) + scalarB >= 0) ? 1 : -1;
-    int retB = (dot(n,r) + scalarB >= 0) ? 1 : -1;
+    // n.p + b >= 0 (for the implicit form of the line from a to b) is
+    // the same as a, b, p being clockwise (or collinear)
+    int retA = (orient2d(a, b, p) <= 0.0) ? 1 : -1;
+    int retB = (orient2d(a, b, r) <= 0.0) ? 1 : -1;
     return (retA == retB) ? 1 : -1;
 }
 
@@ -197,8 +246,9 @@ int testHalfspace(const Matrix<2,1>& p, const Matrix<2,1>& r,
  *  @param b scalar paramter of homogeneous form 
  *  @return signed of half space of point 
  */
-template <int N>
-int testHalfspace(const Matrix<2,1>& p, const Matrix<2,1>& n, double b)
+template <int N, class P, class M>
+int testHalfspace(const MatrixExpression<P,2,1>& p,
+                  const MatrixExpression<M,2,1>& n, double b)
 {
     return (dot(n,p) + b >= 0) ? 1 : -1;
 }
@@ -215,9 +265,9 @@ int testHalfspace(const Matrix<2,1>& p, const Matrix<2,1>& n, double b)
  * @param s   The second vertex of the triangle
  * @param t   The third vertex of the triangle
  */
-template <int N>
-bool inside(const Matrix<2,1>& p, 
-            const Matrix<2,1>& r, const Matrix<2,1>& s, const Matrix<2,1>& t)
+template <int N, class P, class R, class S, class T>
+bool inside(const MatrixExpression<P,2,1>& p, const MatrixExpression<R,2,1>& r,
+            const MatrixExpression<S,2,1>& s, const MatrixExpression<T,2,1>& t)
 {
     int sign1 = signedArea<2>(p,r,s);
     int sign2 = signedArea<2>(p,s,t);
@@ -266,22 +316,455 @@ bool intersect(const Matrix<2,1>& p, const Matrix<2,1>& q,
                const Matrix<2,1>& r, const Matrix<2,1>& s,
                double& alpha, double& beta)
 {
-    Vector<2> n,t, pq, rs;
-    double ai, bi;
+    Vector<2> pq, rs;
+
+    //the lines are parallel if and only if (q-p) x (s-r) is exactly 0
+    if(cross2d(p, q, r, s) == 0.0)
+        return false;
+
+    //change to parametric form and calculate intersection point
+    pq = q - p, rs = s - r;
+
+    alpha = dot((r - p), perp<2>(rs)) / dot(pq, perp<2>(rs));
+    beta = dot((p - r), perp<2>(pq)) / dot(rs, perp<2>(pq));
+
+    return true;
+}
+
+
+/**
+ * An intersection of two line segments (see intersectSegments())
+ */
+struct SegmentIntersection
+{
+    int    first, second;   // The indexes of the segments (first < second)
+    double alpha, beta;     // The weights (as calculated by intersect())
+};
+
+
+// The event points, status and predicates of the sweep in
+// intersectSegments()
+
+/**
+ * A point in the order of the sweep (left to right and, at the same x,
+ * bottom to top)
+ */
+struct SweepPoint
+{
+    double x, y;
+
+    bool operator<(const SweepPoint& other) const
+    {
+        return x < other.x || (x == other.x && y < other.y);
+    }
+
+    bool operator==(const SweepPoint& other) const
+    {
+        return x == other.x && y == other.y;
+    }
+};
+
+/**
+ * The segments that start at an event point, and the pairs of segments
+ * that cross at it
+ */
+struct SweepEvent
+{
+    std::vector<int>                  starts;
+    std::vector< std::pair<int,int> > crossings;
+};
+
+/**
+ * orient2d() for SweepPoint objects
+ */
+inline double sweepOrient(const SweepPoint& a, const SweepPoint& b,
+                          const SweepPoint& c)
+{
+    const double pa[2] = {a.x, a.y}, pb[2] = {b.x, b.y}, pc[2] = {c.x, c.y};
+
+    return orient2d(pa, pb, pc);
+}
+
+/**
+ * Determine whether two segments (each from its left to its right
+ * endpoint) meet, and where
+ *
+ * @param crossing   The point where they meet (returned), which is
+ *                   exact if it is an endpoint of either segment
+ * @return           true if they meet (false if they don't or they are
+ *                   collinear)
+ */
+inline bool sweepCrossing(const SweepPoint& al, const SweepPoint& ar,
+                          const SweepPoint& bl, const SweepPoint& br,
+                          SweepPoint* crossing)
+{
+    double o1 = sweepOrient(al, ar, bl), o2 = sweepOrient(al, ar, br);
+    double o3 = sweepOrient(bl, br, al), o4 = sweepOrient(bl, br, ar);
+
+    if((o1 == 0.0 && o2 == 0.0) ||
+       (o1 > 0.0 && o2 > 0.0) || (o1 < 0.0 && o2 < 0.0) ||
+       (o3 > 0.0 && o4 > 0.0) || (o3 < 0.0 && o4 < 0.0))
+        return false;
+
+    if(o1 == 0.0)
+        *crossing = bl;
+    else if(o2 == 0.0)
+        *crossing = br;
+    else if(o3 == 0.0)
+        *crossing = al;
+    else if(o4 == 0.0)
+        *crossing = ar;
+    else
+    {
+        // o3 and o4 are (proportional to) the distances of a's
+        // endpoints from b's line
+        double t = o3 / (o3 - o4);
+        double x = al.x + t * (ar.x - al.x);
+
+        // Keep the (rounded) point within both segments
+        double xMin = (al.x > bl.x) ? al.x : bl.x;
+        double xMax = (ar.x < br.x) ? ar.x : br.x;
+        crossing->x = (x < xMin) ? xMin : ((x > xMax) ? xMax : x);
+        crossing->y = al.y + t * (ar.y - al.y);
+    }
+    return true;
+}
+
+/**
+ * Determine whether two segments are collinear (i.e., whether a sweep
+ * can't order them)
+ */
+inline bool sweepCollinear(const SweepPoint& al, const SweepPoint& ar,
+                           const SweepPoint& bl, const SweepPoint& br)
+{
+    return sweepOrient(al, ar, bl) == 0.0 && sweepOrient(al, ar, br) == 0.0;
+}
+
+/**
+ * Determine whether two (computed) event points are the same up to
+ * roundoff (e.g., the intersections of three segments that meet at a
+ * point that isn't representable)
+ */
+inline bool sweepNear(const SweepPoint& a, const SweepPoint& b)
+{
+    double scale = 1.0 + std::fmax(std::fabs(a.x), std::fabs(a.y));
+    double tolerance = 1.0e-12 * scale;
+
+    return std::fabs(a.x - b.x) <= tolerance && std::fabs(a.y - b.y) <= tolerance;
+}
+
+/**
+ * The order of the segments that cross the sweep line (bottom to top)
+ * at (just after) the current event point. Segments are only inserted
+ * at an event point that they go through, so they are ordered by
+ * orient2d() relative to it, and those that go through it by direction
+ * (i.e., by the sign of cross2d()).
+ */
+struct SweepStatusCompare
+{
+    typedef void is_transparent;
+
+    const std::vector<SweepPoint>* left;
+    const std::vector<SweepPoint>* right;
+    const std::vector<char>*       through;   // Which go through point
+    const SweepPoint*              point;     // The current event point
+
+    // Whether segment s is below the point p (or p is above it)
+    bool operator()(int s, const SweepPoint& p) const
+    {
+        return sweepOrient((*left)[s], (*right)[s], p) > 0.0;
+    }
+
+    bool operator()(const SweepPoint& p, int s) const
+    {
+        return sweepOrient((*left)[s], (*right)[s], p) < 0.0;
+    }
+
+    // Whether segment s is below segment t
+    bool operator()(int s, int t) const
+    {
+        if(s == t)
+            return false;
+
+        bool sThrough = (*through)[s] != 0, tThrough = (*through)[t] != 0;
+        if(sThrough && tThrough)
+        {
+            const double ls[2] = {(*left)[s].x, (*left)[s].y};
+            const double rs[2] = {(*right)[s].x, (*right)[s].y};
+            const double lt[2] = {(*left)[t].x, (*left)[t].y};
+            const double rt[2] = {(*right)[t].x, (*right)[t].y};
+            double c = cross2d(ls, rs, lt, rt);
+
+            return (c != 0.0) ? c > 0.0 : s < t;
+        }
+        if(sThrough || tThrough)
+        {
+            // Only one of them goes through the point (if the other one
+            // does too, then it is equivalent to neither, so use the
+            // indexes to keep the order strict)
+            int    other = sThrough ? t : s;
+            double o = sweepOrient((*left)[other], (*right)[other], *point);
+
+            if(o == 0.0)
+                return s < t;
+            return sThrough ? o < 0.0 : o > 0.0;
+        }
+
+        return yAt(s) < yAt(t) || (yAt(s) == yAt(t) && s < t);
+    }
+
+    // The height of segment s at the current event point
+    double yAt(int s) const
+    {
+        const SweepPoint& l = (*left)[s];
+        const SweepPoint& r = (*right)[s];
+
+        if(r.x == l.x)
+            return l.y;
+        return l.y + (point->x - l.x) * (r.y - l.y) / (r.x - l.x);
+    }
+};
+
+
+/**
+ * Find all of the intersections of a batch of line segments (e.g., the
+ * edges of a wireframe) using a Bentley-Ottmann sweep.
+ *
+ * A vertical line sweeps from left to right, stopping at the endpoints
+ * and at the intersections (which are found as they are passed). The
+ * segments that cross the sweep line are kept in order (bottom to top),
+ * and only segments that are next to each other in that order are
+ * tested for an intersection. So, this takes O((n+k) log n) time for n
+ * segments with k intersections (rather than O(n^2) for testing every
+ * pair).
+ *
+ * The order of the events and of the segments, and whether two segments
+ * meet, are decided with the robust predicates in Predicates.hpp, so
+ * segments that share an endpoint or touch are handled consistently.
+ * Only the (interior) intersection points are rounded.
+ *
+ * Collinear segments (and segments with no length) are not reported
+ * (since, like intersect(), the weights aren't defined for them).
+ *
+ * Note: This is a function template to avoid problems of duplicate
+ * definitions when linking
+ *
+ * @param segments  The segments (each with its endpoints in the columns)
+ * @return          The intersections (each pair of segments once), with
+ *                  alpha and beta as calculated by intersect() for the
+ *                  line from column 0 to column 1 of each segment
+ */
+template <int N>
+std::vector<SegmentIntersection>
+intersectSegments(const std::vector< Matrix<2,2> >& segments)
+{
+    typedef std::set<int, SweepStatusCompare> Status;
+
+    int n = (int)segments.size();
+    std::vector<SweepPoint>         left(n), right(n);
+    std::vector<char>               through(n, 0), active(n, 0), grouped(n, 0);
+    std::vector<Status::iterator>   where(n);
+    std::map<SweepPoint, SweepEvent> events;
+    std::set< std::pair<int,int> >  tested, reported;
+    std::vector<SegmentIntersection> result;
+    SweepPoint                      point = {0.0, 0.0};
+
+    for(int i = 0; i < n; ++i)
+    {
+        SweepPoint a = {segments[i].get(0,0), segments[i].get(1,0)};
+        SweepPoint b = {segments[i].get(0,1), segments[i].get(1,1)};
+
+        if(a == b)
+            continue;
+        if(b < a)
+            std::swap(a, b);
+
+        left[i]  = a;
+        right[i] = b;
+        events[a].starts.push_back(i);
+        events[b];
+    }
+
+    SweepStatusCompare compare = {&left, &right, &through, &point};
+    Status             status(compare);
+
+    //schedule the intersection of two segments that are next to each
+    //other (once)
+    auto test = [&](int a, int b)
+    {
+        SweepPoint crossing;
+
+        if(!tested.insert(std::make_pair(std::min(a, b), std::max(a, b))).second)
+            return;
+        if(!sweepCrossing(left[a], right[a], left[b], right[b], &crossing))
+            return;
+
+        //an intersection that was rounded behind the sweep line is
+        //handled at the current event point
+        if(crossing < point)
+            crossing = point;
+        events[crossing].crossings.push_back(std::make_pair(a, b));
+    };
 
-    ai = toImplicit<2>(p, q, &n);
-    bi = toImplicit<2>(r, s, &t);
+    //test two neighbors, and (since collinear segments hide each other)
+    //the segments that are collinear with either of them
+    auto testNeighbors = [&](Status::iterator below, Status::iterator above)
+    {
+        for(Status::iterator b = below; ; --b)
+        {
+            if(b != below &&
+               !sweepCollinear(left[*b], right[*b], left[*below], right[*below]))
+                break;
+
+            for(Status::iterator a = above; a != status.end(); ++a)
+            {
+                if(a != above &&
+                   !sweepCollinear(left[*a], right[*a], left[*above], right[*above]))
+                    break;
+                test(*b, *a);
+            }
+            if(b == status.begin())
+                break;
+        }
+    };
+
+    //report two segments that meet at the current event point (once)
+    auto report = [&](int a, int b)
+    {
+        SegmentIntersection found;
+        SweepPoint          crossing;
+
+        found.first  = std::min(a, b);
+        found.second = std::max(a, b);
+        if(!reported.insert(std::make_pair(found.first, found.second)).second)
+            return;
+        tested.insert(std::make_pair(found.first, found.second));
+
+        const Matrix<2,2>& p = segments[found.first];
+        const Matrix<2,2>& r = segments[found.second];
+        if(sweepCrossing(left[a], right[a], left[b], right[b], &crossing) &&
+           intersect<2>(p.getColumn(0), p.getColumn(1),
+                        r.getColumn(0), r.getColumn(1),
+                        found.alpha, found.beta))
+            result.push_back(found);
+    };
 
-    //if they are intersected, calculate intersection point
-    if( n != t )
+    while(!events.empty())
     {
-       //change to parametric form
-       pq = q - p, rs = s - r;
-       
-       alpha = dot((r - p), perp<2>(rs)) / dot(pq, perp<2>(rs));
-       beta = dot((p - r), perp<2>(pq)) / dot(rs, perp<2>(pq));
+        point            = events.begin()->first;
+        SweepEvent event = events.begin()->second;
+        events.erase(events.begin());
+
+        //the segments that go through the point: those that start at it,
+        //those that end at it or contain it, and those found to cross at
+        //it (unless they were already handled at a nearby point)
+        std::vector<int> group;
+        auto add = [&](int s)
+        {
+            if(!grouped[s])
+            {
+                grouped[s] = 1;
+                group.push_back(s);
+            }
+        };
+
+        for(size_t g = 0; g < event.starts.size(); ++g)
+            add(event.starts[g]);
+        std::pair<Status::iterator, Status::iterator> range = status.equal_range(point);
+        for(Status::iterator s = range.first; s != range.second; ++s)
+            add(*s);
+        for(size_t c = 0; c < event.crossings.size(); ++c)
+        {
+            int a = event.crossings[c].first, b = event.crossings[c].second;
+
+            if(active[a] && active[b] &&
+               !reported.count(std::make_pair(std::min(a, b), std::max(a, b))))
+            {
+                add(a);
+                add(b);
+            }
+        }
+
+        //an intersection (that isn't representable) of three or more
+        //segments is rounded differently for each pair, so also take the
+        //neighbors that meet the group at (nearly) this point, or that
+        //are collinear with a segment in it
+        for(size_t g = 0; g < group.size(); ++g)
+        {
+            if(!active[group[g]])
+                continue;
+
+            Status::iterator s = where[group[g]];
+            Status::iterator neighbors[2] = {s, std::next(s)};
+            if(s != status.begin())
+                neighbors[0] = std::prev(s);
+            for(int k = 0; k < 2; ++k)
+            {
+                SweepPoint crossing;
+
+                if(neighbors[k] == s || neighbors[k] == status.end() ||
+                   grouped[*neighbors[k]])
+                    continue;
+                const SweepPoint& l = left[*neighbors[k]];
+                const SweepPoint& r = right[*neighbors[k]];
+                if(sweepCollinear(left[group[g]], right[group[g]], l, r) ||
+                   (sweepCrossing(left[group[g]], right[group[g]], l, r, &crossing) &&
+                    sweepNear(crossing, point)))
+                    add(*neighbors[k]);
+            }
+        }
+
+        for(size_t g = 0; g < group.size(); ++g)
+            for(size_t h = g + 1; h < group.size(); ++h)
+                report(group[g], group[h]);
+
+        //take them out of the status, and put back (in their order after
+        //the point) those that don't end at it
+        std::vector<int> continuing;
+        for(size_t g = 0; g < group.size(); ++g)
+        {
+            int s = group[g];
+
+            grouped[s] = 0;
+            if(active[s])
+            {
+                status.erase(where[s]);
+                active[s] = 0;
+            }
+            if(!(right[s] == point))
+            {
+                through[s] = 1;
+                continuing.push_back(s);
+            }
+        }
+        for(size_t c = 0; c < continuing.size(); ++c)
+        {
+            where[continuing[c]]  = status.insert(continuing[c]).first;
+            active[continuing[c]] = 1;
+        }
+
+        //test the new neighbors
+        if(continuing.empty())
+        {
+            Status::iterator above = status.lower_bound(point);
+            if(above != status.begin() && above != status.end())
+                testNeighbors(std::prev(above), above);
+        }
+        for(size_t c = 0; c < continuing.size(); ++c)
+        {
+            Status::iterator s = where[continuing[c]];
+            Status::iterator next = std::next(s);
+
+            if(s != status.begin() && !through[*std::prev(s)])
+                testNeighbors(std::prev(s), s);
+            if(next != status.end() && !through[*next])
+                testNeighbors(s, next);
+        }
+        for(size_t c = 0; c < continuing.size(); ++c)
+            through[continuing[c]] = 0;
     }
-    return (n != t) ? true : false;
+
+    return result;
 }
 
 
@@ -291,11 +774,11 @@ bool intersect(const Matrix<2,1>& p, const Matrix<2,1>& q,
  * @param a   The 2-vector (which is a Mtrix<2,1> to increase flexibility)
  * @return    The perpendicular (i.e., [-a[1], a[0]])
  */
-template <int N>
-Vector<2> perp(const Matrix<2,1>& a)
+template <int N, class A>
+Vector<2> perp(const MatrixExpression<A,2,1>& a)
 {
     Vector<2> ret;
-    ret = {-a.get(1,0), a.get(0,0)};
+    ret = {-a.element(1,0), a.element(0,0)};
     return ret;
 }
 
@@ -317,8 +800,9 @@ Vector<2> perp(const Matrix<2,1>& a)
  * @param n  The vector parameter of the homogenous form (returned)
  * @return   The scalar parameter of the homogenous form
  */
-template <int N>
-double toImplicit(const Matrix<2,1>& p, const Matrix<2,1>& q, Matrix<2,1>* n)
+template <int N, class P, class Q>
+double toImplicit(const MatrixExpression<P,2,1>& p,
+                  const MatrixExpression<Q,2,1>& q, Matrix<2,1>* n)
 {
     double ret;
     
@@ -327,4 +811,1001 @@ double toImplicit(const Matrix<2,1>& p, const Matrix<2,1>& q, Matrix<2,1>* n)
     return ret;
 }
 
+
+/**
+ * Determine whether one rectangle (e.g., the bounds of a polygon)
+ * is inside of another (e.g., the window)
+ *
+ * @param outer  The outer rectangle (as returned by getBounds())
+ * @param inner  The inner rectangle (as returned by getBounds())
+ * @return       true if inner is inside of (or on) outer
+ */
+template <int R>
+bool contains(const Matrix<R,2>& outer, const Matrix<R,2>& inner)
+{
+    for(int i = 0; i < R; ++i)
+    {
+        if(inner.get(i,0) < outer.get(i,0) || inner.get(i,1) > outer.get(i,1))
+            return false;
+    }
+    return true;
+}
+
+
+/**
+ * Clip a line segment against a rectangle (e.g., the window)
+ *
+ * This is the parametric (Liang-Barsky) version of the
+ * Sutherland-Hodgman clip below: the part of p + t (q - p) that is
+ * inside all four sides of the rectangle is found by narrowing the
+ * range of t one side at a time.
+ *
+ * @param p      One endpoint (replaced by the clipped one)
+ * @param q      The other endpoint (replaced by the clipped one)
+ * @param window The rectangle (column 0 contains the minimum values and
+ *               column 1 the maximum values, as returned by getBounds())
+ * @return       true if any of the line segment is inside the rectangle
+ *               (false if it is all outside, in which case p and q are
+ *               unchanged)
+ */
+template <int N>
+bool clipLine(Matrix<2,1>& p, Matrix<2,1>& q, const Matrix<2,2>& window)
+{
+    double t0 = 0.0, t1 = 1.0;
+    double start[2] = {p.get<0,0>(), p.get<1,0>()};
+    double delta[2] = {q.get<0,0>() - start[0], q.get<1,0>() - start[1]};
+
+    for(int axis = 0; axis < 2; ++axis)
+    {
+        // The distance inside the minimum side is (start - min) + t delta
+        // and the distance inside the maximum side is (max - start) - t delta
+        double inside[2] = {start[axis] - window.get(axis,0),
+                            window.get(axis,1) - start[axis]};
+        double rate[2]   = {delta[axis], -delta[axis]};
+
+        for(int side = 0; side < 2; ++side)
+        {
+            if(rate[side] == 0.0)
+            {
+                //parallel to the side, so all inside or all outside
+                if(inside[side] < 0.0)
+                    return false;
+            }
+            else
+            {
+                double t = -inside[side] / rate[side];
+                if(rate[side] > 0.0)
+                    t0 = (t > t0) ? t : t0;   //entering
+                else
+                    t1 = (t < t1) ? t : t1;   //leaving
+            }
+        }
+    }
+
+    if(t0 > t1)
+        return false;
+
+    if(t1 < 1.0)
+        q.assign(start[0] + t1 * delta[0], start[1] + t1 * delta[1]);
+    if(t0 > 0.0)
+        p.assign(start[0] + t0 * delta[0], start[1] + t0 * delta[1]);
+
+    return true;
+}
+
+
+/**
+ * Clip a convex polygon with N vertices (e.g., a triangle or a
+ * quadrilateral) against a rectangle (e.g., the window), using the
+ * Sutherland-Hodgman algorithm: the polygon is clipped against one side
+ * of the rectangle at a time, keeping the vertices that are inside the
+ * side and adding a vertex wherever an edge crosses it.
+ *
+ * Each side can add (at most) one vertex to a convex polygon, so the
+ * result has at most N + 4 vertices. The columns after the last vertex
+ * repeat it (so that getBounds() and EdgeFunctions can be used on the
+ * result as is).
+ *
+ * Note: The point where an edge crosses a side is calculated from the
+ * edge's endpoints in the same order whichever way the edge goes, so
+ * two polygons that share an edge are clipped to the same vertices.
+ *
+ * @param polygon  The vertices of the polygon
+ * @param window   The rectangle (column 0 contains the minimum values and
+ *                 column 1 the maximum values, as returned by getBounds())
+ * @param clipped  The vertices of the clipped polygon (returned)
+ * @return         The number of vertices of the clipped polygon (which is
+ *                 0 if the polygon is outside of the rectangle)
+ * @throws         length_error if the polygon isn't convex (and so the
+ *                 clipped polygon has more than N + 4 vertices)
+ */
+template <int N>
+int clipPolygon(const Matrix<2,N>& polygon, const Matrix<2,2>& window,
+                Matrix<2,N+4>* clipped)
+{
+    // Two buffers that the sides clip from and to in turn
+    double xs[2][N+4], ys[2][N+4];
+    int    count = N, from = 0;
+
+    for(int i = 0; i < N; ++i)
+    {
+        xs[0][i] = polygon.get(0,i);
+        ys[0][i] = polygon.get(1,i);
+    }
+
+    for(int side = 0; side < 4 && count > 0; ++side)
+    {
+        int     axis  = side / 2;
+        double  bound = window.get(axis, side % 2);
+        double  sign  = (side % 2 == 0) ? 1.0 : -1.0;   //inside is >= min, <= max
+        double* u[2]  = {xs[from], ys[from]};           //u[axis] is clipped
+        double* v[2]  = {xs[1 - from], ys[1 - from]};
+        int     out   = 0;
+
+        for(int i = 0; i < count; ++i)
+        {
+            int  s = (i + count - 1) % count;   //the previous vertex
+            bool sInside = sign * (u[axis][s] - bound) >= 0.0;
+            bool pInside = sign * (u[axis][i] - bound) >= 0.0;
+
+            if(sInside != pInside)
+            {
+                if(out >= N + 4)
+                    throw std::length_error("clipPolygon: the polygon isn't convex");
+
+                //order the endpoints (so that the result doesn't depend
+                //on the direction of the edge)
+                int a = s, b = i;
+                if(u[axis][a] > u[axis][b])
+                    std::swap(a, b);
+
+                double t = (bound - u[axis][a]) / (u[axis][b] - u[axis][a]);
+                v[axis][out]     = bound;
+                v[1 - axis][out] = u[1 - axis][a] + t * (u[1 - axis][b] - u[1 - axis][a]);
+                ++out;
+            }
+            if(pInside)
+            {
+                if(out >= N + 4)
+                    throw std::length_error("clipPolygon: the polygon isn't convex");
+
+                v[0][out] = u[0][i];
+                v[1][out] = u[1][i];
+                ++out;
+            }
+        }
+
+        count = out;
+        from  = 1 - from;
+    }
+
+    for(int i = 0; i < N + 4; ++i)
+    {
+        int k = (i < count) ? i : count - 1;
+        (*clipped)(0,i) = (count > 0) ? xs[from][k] : 0.0;
+        (*clipped)(1,i) = (count > 0) ? ys[from][k] : 0.0;
+    }
+
+    return count;
+}
+
+
+/**
+ * The edge functions of a convex polygon with N vertices (e.g., a
+ * triangle or a quadrilateral), for filling it pixel by pixel.
+ *
+ * The edge function of the edge from v[i] to v[i+1] is
+ *
+ *   E_i(x, y) = A_i x + B_i y + C_i  (= orient2d(v[i], v[i+1], (x, y)))
+ *
+ * A, B and C are calculated once (per polygon), after which moving one
+ * pixel right adds A_i and moving one pixel up adds B_i, so a fill loop
+ * is just integer additions and sign tests:
+ *
+ *   EdgeFunctions<3> edges(triangle);
+ *   long long        row[3], e[3];
+ *
+ *   edges.evaluate(xMin, yMin, row);
+ *   for (int y = yMin; y <= yMax; ++y, edges.stepY(row))
+ *   {
+ *       std::copy(row, row + 3, e);
+ *       for (int x = xMin; x <= xMax; ++x, edges.stepX(e))
+ *           if (edges.inside(e))
+ *               fb->setPixel(x, y, color);
+ *   }
+ *
+ * The vertices are snapped to 1/2^SUBPIXEL_BITS of a pixel, so the
+ * edge functions are exact (for coordinates of less than MAX_COORDINATE,
+ * i.e., 2^20 pixels).
+ * The edges are oriented counterclockwise (whatever the order of the
+ * vertices) and a pixel exactly on an edge belongs to the polygon only
+ * if the edge is a "left" or "top" edge. So, polygons that share an
+ * edge never both draw (or both miss) the pixels on it.
+ *
+ * coverage() tests BATCH (i.e., 8) consecutive pixels at once (with
+ * AVX2 or SSE2 when they are available) and returns a bitmask, so a fill
+ * loop can write runs of pixels:
+ *
+ *   for (int x = xMin; x <= xMax; x += edges.BATCH, edges.stepX(e, edges.BATCH))
+ *   {
+ *       unsigned int mask = edges.coverage(e);   // Bit k is pixel x + k
+ *       ...
+ *   }
+ *
+ * Note: This is a template (like the functions above) so that it is
+ * one-to-one with Matrix<2,N>
+ */
+template <int N>
+class EdgeTable;
+
+template <int N>
+class EdgeFunctions
+{
+  public:
+    static const int SUBPIXEL_BITS = 8;
+    static const int BATCH = 8;
+    static const int MAX_COORDINATE = 1 << 20;
+
+    /**
+     * Set up the edge functions of a convex polygon
+     *
+     * @param polygon   The vertices (in either order)
+     */
+    EdgeFunctions(const Matrix<2,N>& polygon);
+
+    /**
+     * Determine which of BATCH consecutive pixels are inside the
+     * polygon
+     *
+     * @param e   The N values of the first (i.e., leftmost) pixel
+     * @return    A bitmask in which bit k is set if pixel k is inside
+     */
+    unsigned int coverage(const long long* e) const;
+
+    /**
+     * Evaluate the edge functions at a pixel
+     *
+     * @param x   The horizontal coordinate
+     * @param y   The vertical coordinate
+     * @param e   The N values (returned)
+     */
+    void evaluate(int x, int y, long long* e) const;
+
+    /**
+     * Determine whether the pixel with the given edge function values is
+     * inside the polygon
+     *
+     * @param e   The N values
+     * @return    true if the pixel is inside
+     */
+    bool inside(const long long* e) const;
+
+    /**
+     * Determine whether the polygon is empty (i.e., has no area)
+     *
+     * @return   true if it is empty
+     */
+    bool isEmpty() const;
+
+    /**
+     * Move the edge function values one pixel to the right
+     *
+     * @param e   The N values (updated)
+     */
+    void stepX(long long* e) const;
+
+    /**
+     * Move the edge function values n pixels to the right
+     *
+     * @param e   The N values (updated)
+     * @param n   The number of pixels
+     */
+    void stepX(long long* e, int n) const;
+
+    /**
+     * Move the edge function values one pixel up
+     *
+     * @param e   The N values (updated)
+     */
+    void stepY(long long* e) const;
+
+  private:
+    long long a[N], b[N], c[N];
+    bool      empty;
+
+    // EdgeTable finds the ends of the spans from the same edge functions
+    template <int M> friend class EdgeTable;
+
+    // ramp[i][k] = k A_i (i.e., the change in E_i over k pixels)
+    alignas(32) long long ramp[N][BATCH];
+};
+
+/**
+ * Set up the edge functions of a convex polygon
+ *
+ * @param polygon   The vertices (in either order)
+ */
+template <int N>
+EdgeFunctions<N>::EdgeFunctions(const Matrix<2,N>& polygon)
+{
+    const double scale = (double)(1 << SUBPIXEL_BITS);
+    long long    x[N], y[N];
+    long long    twiceArea = 0;
+
+    for(int i = 0; i < N; ++i)
+    {
+        x[i] = llround(polygon.get(0,i) * scale);
+        y[i] = llround(polygon.get(1,i) * scale);
+    }
+
+    for(int i = 0; i < N; ++i)
+    {
+        int j = (i + 1) % N;
+
+        // E_i(p) = (v[j] - v[i]) x (p - v[i]) (in subpixels)
+        this->a[i] = y[i] - y[j];
+        this->b[i] = x[j] - x[i];
+        this->c[i] = x[i] * y[j] - x[j] * y[i];
+        twiceArea += this->c[i];
+    }
+
+    this->empty = (twiceArea == 0);
+    for(int i = 0; i < N; ++i)
+    {
+        // Orient the edges counterclockwise
+        if(twiceArea < 0)
+        {
+            this->a[i] = -this->a[i];
+            this->b[i] = -this->b[i];
+            this->c[i] = -this->c[i];
+        }
+
+        // A pixel on a left or top edge (i.e., one that goes down, or
+        // goes left and is horizontal) is inside (E_i >= 0), one on the
+        // other edges isn't (E_i > 0, i.e., E_i - 1 >= 0)
+        // (A repeated vertex, e.g., the padding of clipPolygon(), gives
+        // an edge with no length, which is ignored, i.e., E_i = 0)
+        long long dx = this->b[i], dy = -this->a[i];
+        if((dx != 0 || dy != 0) && !(dy < 0 || (dy == 0 && dx < 0)))
+            this->c[i] -= 1;
+
+        // The pixels are at whole coordinates, so moving one pixel
+        // changes E_i by A_i or B_i times the subpixel scale
+        this->a[i] *= (1 << SUBPIXEL_BITS);
+        this->b[i] *= (1 << SUBPIXEL_BITS);
+
+        for(int k = 0; k < BATCH; ++k)
+            this->ramp[i][k] = k * this->a[i];
+    }
+}
+
+/**
+ * Determine which of BATCH consecutive pixels are inside the polygon.
+ *
+ * A pixel is inside if none of its edge function values is negative,
+ * i.e., if the sign bit of the OR of them is 0. The values of the
+ * BATCH pixels are the first one's plus the ramp, so with AVX2 this is
+ * two additions (and ORs) per edge and one movemask per four pixels.
+ *
+ * @param e   The N values of the first (i.e., leftmost) pixel
+ * @return    A bitmask in which bit k is set if pixel k is inside
+ */
+template <int N>
+unsigned int EdgeFunctions<N>::coverage(const long long* e) const
+{
+    if(this->empty)
+        return 0;
+
+#if defined(GEOMETRY_SIMD_AVX2)
+    __m256i low  = _mm256_setzero_si256();
+    __m256i high = _mm256_setzero_si256();
+    for(int i = 0; i < N; ++i)
+    {
+        __m256i start = _mm256_set1_epi64x(e[i]);
+        low  = _mm256_or_si256(low, _mm256_add_epi64(start,
+                   _mm256_load_si256((const __m256i*)&this->ramp[i][0])));
+        high = _mm256_or_si256(high, _mm256_add_epi64(start,
+                   _mm256_load_si256((const __m256i*)&this->ramp[i][4])));
+    }
+    unsigned int outside = _mm256_movemask_pd(_mm256_castsi256_pd(low)) |
+                           (_mm256_movemask_pd(_mm256_castsi256_pd(high)) << 4);
+#elif defined(GEOMETRY_SIMD_SSE2)
+    __m128i lanes[BATCH / 2];
+    for(int k = 0; k < BATCH / 2; ++k)
+        lanes[k] = _mm_setzero_si128();
+    for(int i = 0; i < N; ++i)
+    {
+        __m128i start = _mm_set1_epi64x(e[i]);
+        for(int k = 0; k < BATCH / 2; ++k)
+            lanes[k] = _mm_or_si128(lanes[k], _mm_add_epi64(start,
+                           _mm_load_si128((const __m128i*)&this->ramp[i][2*k])));
+    }
+    unsigned int outside = 0;
+    for(int k = 0; k < BATCH / 2; ++k)
+        outside |= _mm_movemask_pd(_mm_castsi128_pd(lanes[k])) << (2*k);
+#else
+    unsigned int outside = 0;
+    for(int k = 0; k < BATCH; ++k)
+    {
+        long long signs = 0;
+        for(int i = 0; i < N; ++i)
+            signs |= e[i] + this->ramp[i][k];
+        if(signs < 0)
+            outside |= 1u << k;
+    }
+#endif
+
+    return ~outside & ((1u << BATCH) - 1);
+}
+
+/**
+ * Evaluate the edge functions at a pixel
+ *
+ * @param x   The horizontal coordinate
+ * @param y   The vertical coordinate
+ * @param e   The N values (returned)
+ */
+template <int N>
+void EdgeFunctions<N>::evaluate(int x, int y, long long* e) const
+{
+    for(int i = 0; i < N; ++i)
+        e[i] = this->a[i] * x + this->b[i] * y + this->c[i];
+}
+
+/**
+ * Determine whether the pixel with the given edge function values is
+ * inside the polygon
+ *
+ * @param e   The N values
+ * @return    true if the pixel is inside (i.e., all of them are >= 0)
+ */
+template <int N>
+bool EdgeFunctions<N>::inside(const long long* e) const
+{
+    long long signs = 0;
+
+    for(int i = 0; i < N; ++i)
+        signs |= e[i];
+
+    return !this->empty && signs >= 0;
+}
+
+/**
+ * Determine whether the polygon is empty (i.e., has no area)
+ *
+ * @return   true if it is empty
+ */
+template <int N>
+bool EdgeFunctions<N>::isEmpty() const
+{
+    return this->empty;
+}
+
+/**
+ * Move the edge function values one pixel to the right
+ *
+ * @param e   The N values (updated)
+ */
+template <int N>
+void EdgeFunctions<N>::stepX(long long* e) const
+{
+    for(int i = 0; i < N; ++i)
+        e[i] += this->a[i];
+}
+
+/**
+ * Move the edge function values n pixels to the right
+ *
+ * @param e   The N values (updated)
+ * @param n   The number of pixels
+ */
+template <int N>
+void EdgeFunctions<N>::stepX(long long* e, int n) const
+{
+    for(int i = 0; i < N; ++i)
+        e[i] += n * this->a[i];
+}
+
+/**
+ * Move the edge function values one pixel up
+ *
+ * @param e   The N values (updated)
+ */
+template <int N>
+void EdgeFunctions<N>::stepY(long long* e) const
+{
+    for(int i = 0; i < N; ++i)
+        e[i] += this->b[i];
+}
+
+
+/**
+ * Divide, rounding toward negative infinity (rather than toward zero,
+ * like /)
+ *
+ * @param n   The numerator
+ * @param d   The denominator (which must be positive)
+ * @return    floor(n / d)
+ */
+inline long long floorDivide(long long n, long long d)
+{
+    long long q = n / d;
+
+    return (n % d != 0 && n < 0) ? q - 1 : q;
+}
+
+/**
+ * Count the 0 bits below the lowest 1 bit (e.g., to find the first
+ * pixel of a coverage mask)
+ *
+ * @param mask   The bits (which must not all be 0)
+ * @return       The index of the lowest 1 bit
+ */
+inline int countTrailingZeros(unsigned int mask)
+{
+#if defined(__cpp_lib_bitops)
+    return std::countr_zero(mask);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#elif defined(_MSC_VER)
+    unsigned long index;
+
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    int count = 0;
+
+    for(; (mask & 1u) == 0; mask >>= 1)
+        ++count;
+    return count;
+#endif
+}
+
+/**
+ * The pixels of a line segment, one per column (or per row for a steep
+ * line), found incrementally with integer arithmetic (i.e., Bresenham's
+ * algorithm, generalized to endpoints that aren't at whole pixels).
+ *
+ * The pixel in column i is (i, round(y(i))), where y is the line
+ * through the endpoints and round() rounds halves away from zero (like
+ * the parametric approach in Rasterizer2D). Stepping to the next column
+ * is an addition and a comparison:
+ *
+ *   LineStepper<2> line(p, q);
+ *   line.start(xStart);
+ *   for (int x = xStart; x <= xEnd; ++x, line.step())
+ *       fb->setPixel(x, line.getMinor(), color);
+ *
+ * The endpoints are snapped to 1/2^SUBPIXEL_BITS of a pixel (as in
+ * EdgeFunctions), after which everything is exact (for coordinates of
+ * less than MAX_COORDINATE). So, for endpoints at whole pixels, the
+ * pixels are exactly those of the line (whereas the rounding error of
+ * the parametric approach can move a pixel where the line passes
+ * halfway between two pixels).
+ *
+ * Note: This is a template (like the functions above) to avoid problems
+ * of duplicate definitions when linking
+ */
+template <int N>
+class LineStepper
+{
+    static_assert(N == 2, "A LineStepper is only defined in 2 dimensions");
+
+  public:
+    static const int SUBPIXEL_BITS = 8;
+    static const int MAX_COORDINATE = 1 << 20;
+
+    /**
+     * Set up the line from p to q
+     *
+     * @param p   One endpoint
+     * @param q   The other endpoint
+     */
+    LineStepper(const Matrix<N,1>& p, const Matrix<N,1>& q);
+
+    /**
+     * Get the minor (i.e., vertical for a line that is not steep)
+     * coordinate of the current pixel
+     *
+     * @return   The coordinate
+     */
+    int getMinor() const;
+
+    /**
+     * Determine whether the line is stepped along x (i.e., |slope| <= 1)
+     * or along y
+     *
+     * @return   true if it is stepped along x
+     */
+    bool isXMajor() const;
+
+    /**
+     * Move to the given major (i.e., horizontal for a line that is not
+     * steep) coordinate
+     *
+     * @param i   The coordinate
+     */
+    void start(int i);
+
+    /**
+     * Move to the next major coordinate
+     */
+    void step();
+
+  private:
+    // In column i, y = (base + 2^SUBPIXEL_BITS i dv) / d exactly, and the
+    // current pixel is minor, with error = 2 (d y - d minor) + d
+    // (in [0, 2d))
+    long long base, d, dv, error;
+    int       minor;
+    bool      xMajor;
+};
+
+/**
+ * Set up the line from p to q
+ *
+ * @param p   One endpoint
+ * @param q   The other endpoint
+ */
+template <int N>
+LineStepper<N>::LineStepper(const Matrix<N,1>& p, const Matrix<N,1>& q)
+    : error(0), minor(0)
+{
+    const double scale = (double)(1 << SUBPIXEL_BITS);
+    long long    px = llround(p.get(0,0) * scale), py = llround(p.get(1,0) * scale);
+    long long    qx = llround(q.get(0,0) * scale), qy = llround(q.get(1,0) * scale);
+    long long    u0, v0, du, dv;
+
+    this->xMajor = std::llabs(qy - py) <= std::llabs(qx - px);
+    if(this->xMajor)
+        u0 = px, v0 = py, du = qx - px, dv = qy - py;
+    else
+        u0 = py, v0 = px, du = qy - py, dv = qx - px;
+
+    // The same line, stepped in the other direction
+    if(du < 0)
+        du = -du, dv = -dv;
+
+    // A point (i.e., no length) is the same in every column
+    if(du == 0)
+        du = 1, dv = 0, u0 = 0;
+
+    this->base = v0 * du - u0 * dv;
+    this->d    = du << SUBPIXEL_BITS;
+    this->dv   = dv;
+}
+
+/**
+ * Get the minor coordinate of the current pixel
+ *
+ * round(y) is floor(y + 1/2), except that a negative half (i.e., an
+ * error of 0 with minor <= 0) is rounded down (away from zero)
+ *
+ * @return   The coordinate
+ */
+template <int N>
+int LineStepper<N>::getMinor() const
+{
+    return this->minor - ((this->error == 0 && this->minor <= 0) ? 1 : 0);
+}
+
+/**
+ * Determine whether the line is stepped along x
+ *
+ * @return   true if it is stepped along x
+ */
+template <int N>
+bool LineStepper<N>::isXMajor() const
+{
+    return this->xMajor;
+}
+
+/**
+ * Move to the given major coordinate (which takes a division, so it is
+ * done once per line)
+ *
+ * @param i   The coordinate
+ */
+template <int N>
+void LineStepper<N>::start(int i)
+{
+    long long twiceV = 2 * (this->base + (long long)i * (1 << SUBPIXEL_BITS) * this->dv);
+    long long twiceD = 2 * this->d;
+    long long n      = twiceV + this->d;
+    long long m      = floorDivide(n, twiceD);
+
+    this->minor = (int)m;
+    this->error = n - m * twiceD;
+}
+
+/**
+ * Move to the next major coordinate.
+ *
+ * y changes by dv / du (which is in [-1, 1]), so the pixel moves by at
+ * most one.
+ */
+template <int N>
+void LineStepper<N>::step()
+{
+    this->error += this->dv * (2 << SUBPIXEL_BITS);
+    if(this->error >= 2 * this->d)
+    {
+        this->error -= 2 * this->d;
+        this->minor += 1;
+    }
+    else if(this->error < 0)
+    {
+        this->error += 2 * this->d;
+        this->minor -= 1;
+    }
+}
+
+
+/**
+ * The edge table of a convex polygon with N vertices, for filling it a
+ * span (i.e., a run of pixels in a row) at a time.
+ *
+ * The edges are sorted by their lowest row, and each row only uses the
+ * edges that cross it (the active edges). The end of a span on edge i
+ * is where its edge function (see EdgeFunctions) changes sign, i.e.,
+ *
+ *   x >= ceil(-(B_i y + C_i) / A_i)    (if A_i > 0, a left edge)
+ *   x <= floor((B_i y + C_i) / -A_i)   (if A_i < 0, a right edge)
+ *
+ * which is kept as a quotient and a remainder and stepped from row to
+ * row with additions (like LineStepper). So, the spans are exact, and
+ * are the same pixels (including those on the edges) that EdgeFunctions
+ * finds pointwise (unless snapping the vertices made the polygon
+ * concave, in which case only the edges that cross a row bound it):
+ *
+ *   EdgeTable<3> table(triangle);
+ *   int          left, right;
+ *
+ *   table.start(yMin);
+ *   for (int y = yMin; y <= yMax; ++y, table.step())
+ *       if (table.getSpan(&left, &right))
+ *           fb->setPixels(left, y, right - left + 1, color);
+ *
+ * Note: This is a template (like EdgeFunctions) so that it is
+ * one-to-one with Matrix<2,N>
+ */
+template <int N>
+class EdgeTable
+{
+  public:
+    /**
+     * Set up the edge table of a convex polygon
+     *
+     * @param polygon   The vertices (in either order)
+     */
+    EdgeTable(const Matrix<2,N>& polygon);
+
+    /**
+     * Get the span of the current row (which may extend beyond the
+     * polygon's bounding rectangle in a row that doesn't cross it)
+     *
+     * @param left    The leftmost pixel (returned)
+     * @param right   The rightmost pixel (returned)
+     * @return        false if the row has no pixels in the polygon
+     */
+    bool getSpan(int* left, int* right) const;
+
+    /**
+     * Determine whether the polygon is empty (i.e., has no area)
+     *
+     * @return   true if it is empty
+     */
+    bool isEmpty() const;
+
+    /**
+     * Move to the given row (which takes a division per edge, so it is
+     * done once per polygon)
+     *
+     * @param y   The vertical coordinate
+     */
+    void start(int y);
+
+    /**
+     * Move up one row
+     */
+    void step();
+
+  private:
+    // The edge function of edge i in row y is B y + C, and the end of
+    // the span is floor((B y + C) / |A|) = quotient (+ remainder / |A|)
+    struct Edge
+    {
+        long long b, c, k, quotient, remainder, dq, dr;
+        int       yMin, yMax;
+        bool      left;
+    };
+
+    EdgeFunctions<N> functions;
+    Edge             edges[N];
+    int              order[N], active[N];
+    int              activeCount, count, next, y;
+
+    void activate(int i);
+};
+
+/**
+ * Set up the edge table of a convex polygon
+ *
+ * @param polygon   The vertices (in either order)
+ */
+template <int N>
+EdgeTable<N>::EdgeTable(const Matrix<2,N>& polygon)
+    : functions(polygon), activeCount(0), count(0), next(0), y(0)
+{
+    const int    bits = EdgeFunctions<N>::SUBPIXEL_BITS;
+    const double scale = (double)(1 << bits);
+    long long    v[N];
+
+    for(int i = 0; i < N; ++i)
+        v[i] = llround(polygon.get(1,i) * scale);
+
+    for(int i = 0; i < N; ++i)
+    {
+        Edge&     edge = this->edges[i];
+        long long a = this->functions.a[i];
+        long long low = std::min(v[i], v[(i + 1) % N]);
+        long long high = std::max(v[i], v[(i + 1) % N]);
+
+        // The rows that the edge (including its end points) crosses
+        edge.yMin = (int)-floorDivide(-low, 1 << bits);
+        edge.yMax = (int)floorDivide(high, 1 << bits);
+        edge.b    = this->functions.b[i];
+        edge.c    = this->functions.c[i];
+        edge.k    = (a < 0) ? -a : a;
+        edge.left = a > 0;
+
+        // An edge with no length, or one that doesn't cross a row,
+        // doesn't bound any span
+        if((a != 0 || edge.b != 0) && edge.yMin <= edge.yMax)
+            this->order[this->count++] = i;
+    }
+
+    std::sort(this->order, this->order + this->count,
+              [this](int i, int j) { return this->edges[i].yMin < this->edges[j].yMin; });
+}
+
+/**
+ * Add edge i to the active edges (at the current row)
+ *
+ * @param i   The index of the edge
+ */
+template <int N>
+void EdgeTable<N>::activate(int i)
+{
+    Edge&     edge = this->edges[i];
+    long long m = edge.b * this->y + edge.c;
+
+    // A horizontal edge bounds its row (as a whole)
+    if(edge.k != 0)
+    {
+        edge.quotient  = floorDivide(m, edge.k);
+        edge.remainder = m - edge.quotient * edge.k;
+        edge.dq        = floorDivide(edge.b, edge.k);
+        edge.dr        = edge.b - edge.dq * edge.k;
+    }
+    this->active[this->activeCount++] = i;
+}
+
+/**
+ * Get the span of the current row.
+ *
+ * A left edge gives x >= -floor(m / |A|) (= ceil(-m / A)), and a right
+ * edge gives x <= floor(m / |A|), where m = B y + C.
+ *
+ * @param left    The leftmost pixel (returned)
+ * @param right   The rightmost pixel (returned)
+ * @return        false if the row has no pixels in the polygon
+ */
+template <int N>
+bool EdgeTable<N>::getSpan(int* left, int* right) const
+{
+    long long l = LLONG_MIN, r = LLONG_MAX;
+
+    if(this->functions.isEmpty() || this->activeCount == 0)
+        return false;
+
+    for(int j = 0; j < this->activeCount; ++j)
+    {
+        const Edge& edge = this->edges[this->active[j]];
+
+        if(edge.k == 0)
+        {
+            if(edge.b * this->y + edge.c < 0)
+                return false;
+        }
+        else if(edge.left)
+            l = std::max(l, -edge.quotient);
+        else
+            r = std::min(r, edge.quotient);
+    }
+
+    if(l > r)
+        return false;
+
+    *left  = (int)std::max(l, (long long)INT_MIN);
+    *right = (int)std::min(r, (long long)INT_MAX);
+    return true;
+}
+
+/**
+ * Determine whether the polygon is empty
+ *
+ * @return   true if it is empty
+ */
+template <int N>
+bool EdgeTable<N>::isEmpty() const
+{
+    return this->functions.isEmpty();
+}
+
+/**
+ * Move to the given row
+ *
+ * @param y   The vertical coordinate
+ */
+template <int N>
+void EdgeTable<N>::start(int y)
+{
+    this->y = y;
+    this->activeCount = 0;
+
+    for(this->next = 0; this->next < this->count; ++this->next)
+    {
+        int i = this->order[this->next];
+
+        if(this->edges[i].yMin > y)
+            break;
+        if(this->edges[i].yMax >= y)
+            activate(i);
+    }
+}
+
+/**
+ * Move up one row: drop the edges that end below it, step the others
+ * (m increases by B, so the quotient increases by floor(B / |A|) or one
+ * more) and add the edges that start in it
+ */
+template <int N>
+void EdgeTable<N>::step()
+{
+    ++this->y;
+
+    for(int j = 0; j < this->activeCount; )
+    {
+        Edge& edge = this->edges[this->active[j]];
+
+        if(edge.yMax < this->y)
+        {
+            this->active[j] = this->active[--this->activeCount];
+            continue;
+        }
+
+        if(edge.k != 0)
+        {
+            edge.quotient  += edge.dq;
+            edge.remainder += edge.dr;
+            if(edge.remainder >= edge.k)
+            {
+                edge.remainder -= edge.k;
+                edge.quotient  += 1;
+            }
+        }
+        ++j;
+    }
+
+    for(; this->next < this->count; ++this->next)
+    {
+        int i = this->order[this->next];
+
+        if(this->edges[i].yMin > this->y)
+            break;
+        activate(i);
+    }
+}
+
 #endif
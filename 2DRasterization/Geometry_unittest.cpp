@@ -7,6 +7,8 @@
  */
 
 #include <iostream>
+#include <set>
+#include <vector>
 #include <gtest/gtest.h>
 
 #include "Geometry.hpp"
@@ -148,6 +150,22 @@ TEST_F(GeometryUnittest, inside_valid3)
     EXPECT_FALSE(inside<2>(p,a,b,c));
 }
 
+TEST_F(GeometryUnittest, inside_view_valid)
+{
+    Matrix<2,3> triangle;
+    Vector<2>   p, q;
+
+    triangle = { 5, 3, 2,
+                 1, 5, 2 };
+    p = { 3,3 };
+    q = { 2,3 };
+
+    EXPECT_TRUE(inside<2>(p, triangle.columnView(0), triangle.columnView(1),
+                          triangle.columnView(2)));
+    EXPECT_FALSE(inside<2>(q, triangle.columnView(0), triangle.columnView(1),
+                           triangle.columnView(2)));
+}
+
 TEST_F(GeometryUnittest, toImplicit_valid)
 {
     Vector<2> a, b, n;
@@ -200,7 +218,16 @@ TEST_F(GeometryUnittest, intersect_valid)
 
 TEST_F(GeometryUnittest, intersect_valid2)
 {
+    Vector<2> p,q,r,s;
+    double alpha = 0, beta = 0;
+
+    // Parallel lines (with normals of different lengths)
+    p = { 0,0 };
+    q = { 2,2 };
+    r = { 0,1 };
+    s = { 3,4 };
 
+    EXPECT_FALSE(intersect<2>(p,q,r,s,alpha,beta));
 }
 
 TEST_F(GeometryUnittest, intersect_valid3)
@@ -210,12 +237,28 @@ TEST_F(GeometryUnittest, intersect_valid3)
 
 TEST_F(GeometryUnittest, signedarea_valid)
 {
+    Vector<2> p, r, s;
+
+    r = {0, 0};
+    s = {4, 0};
+    p = {1, 3};
 
+    EXPECT_TRUE(signedArea<2>(p, r, s));
+    EXPECT_FALSE(signedArea<2>(p, s, r));
 }
 
 TEST_F(GeometryUnittest, signedarea_valid2)
 {
+    Vector<2> p, r, s;
+
+    // Collinear points have no signed area (even when the plain
+    // determinant would round to a small nonzero value)
+    r = {0.5, 0.5};
+    s = {12, 12};
+    p = {24, 24};
 
+    EXPECT_FALSE(signedArea<2>(p, r, s));
+    EXPECT_FALSE(signedArea<2>(p, s, r));
 }
 
 TEST_F(GeometryUnittest, signedarea_valid3)
@@ -237,3 +280,449 @@ TEST_F(GeometryUnittest, halfspace_valid3)
 {
 
 }
+
+/**
+ * The exact sign of orient2d() for points that are multiples of 2^-53
+ * (so that, scaled by 2^53, the determinant fits in 128 bit integers)
+ */
+static int exactOrientation(const double* a, const double* b, const double* c)
+{
+    const double scale = 9007199254740992.0;   // 2^53
+    __int128 ax = (__int128)(a[0] * scale), ay = (__int128)(a[1] * scale);
+    __int128 bx = (__int128)(b[0] * scale), by = (__int128)(b[1] * scale);
+    __int128 cx = (__int128)(c[0] * scale), cy = (__int128)(c[1] * scale);
+    __int128 det = (ax - cx) * (by - cy) - (ay - cy) * (bx - cx);
+
+    return (det > 0) - (det < 0);
+}
+
+TEST_F(GeometryUnittest, orient2d_near_degenerate_valid)
+{
+    // Points near the line y = x (Shewchuk's example, where the plain
+    // determinant gets many of the signs wrong)
+    const double eps = std::ldexp(1.0, -53);
+    const double b[2] = {12, 12};
+    const double c[2] = {24, 24};
+    int wrong = 0;
+
+    for(int i = 0; i < 64; ++i)
+    {
+        for(int j = 0; j < 64; ++j)
+        {
+            const double a[2] = {0.5 + i * eps, 0.5 + j * eps};
+            double det = orient2d(a, b, c);
+            int sign = (det > 0) - (det < 0);
+            double plain = (a[0] - c[0]) * (b[1] - c[1]) - (a[1] - c[1]) * (b[0] - c[0]);
+
+            EXPECT_EQ(sign, exactOrientation(a, b, c));
+            if(((plain > 0) - (plain < 0)) != exactOrientation(a, b, c))
+                ++wrong;
+        }
+    }
+    EXPECT_GT(wrong, 0);
+}
+
+TEST_F(GeometryUnittest, incircle_valid)
+{
+    Vector<2> a, b, c, d;
+
+    a = {1, 0};
+    b = {0, 1};
+    c = {-1, 0};
+
+    d = {0, -1};
+    EXPECT_EQ(incircle(a, b, c, d), 0.0);
+
+    d = {0.25, 0.5};
+    EXPECT_GT(incircle(a, b, c, d), 0.0);
+
+    d = {2, 2};
+    EXPECT_LT(incircle(a, b, c, d), 0.0);
+
+    // Just inside (the plain determinant can't tell, it is below the
+    // error bound of the fast test)
+    d = {0, std::nextafter(-1.0, 0.0)};
+    EXPECT_GT(incircle(a, b, c, d), 0.0);
+    d = {0, std::nextafter(-1.0, -2.0)};
+    EXPECT_LT(incircle(a, b, c, d), 0.0);
+
+    // Clockwise circles reverse the sign
+    d = {0.25, 0.5};
+    EXPECT_LT(incircle(a, c, b, d), 0.0);
+}
+
+/**
+ * Count how many times each pixel of a w x h grid is covered by a
+ * triangle (by stepping its edge functions)
+ */
+static void cover(const Matrix<2,3>& triangle, int counts[][16])
+{
+    EdgeFunctions<3> edges(triangle);
+    long long row[3], e[3];
+
+    edges.evaluate(0, 0, row);
+    for(int y = 0; y < 16; ++y, edges.stepY(row))
+    {
+        std::copy(row, row + 3, e);
+        for(int x = 0; x < 16; ++x, edges.stepX(e))
+            if(edges.inside(e))
+                ++counts[y][x];
+    }
+}
+
+TEST_F(GeometryUnittest, edge_functions_valid)
+{
+    Matrix<2,3> triangle({1, 13, 4,
+                          2,  5, 14});
+    EdgeFunctions<3> edges(triangle);
+    long long e[3];
+    Vector<2> p;
+
+    // Away from the edges (i.e., at x + 1/64, y + 1/64) the edge
+    // functions agree with inside()
+    Matrix<2,3> offset(1/64.0, 1/64.0, 1/64.0,
+                       1/64.0, 1/64.0, 1/64.0);
+    EdgeFunctions<3> shifted(triangle - offset);
+    for(int y = 0; y < 16; ++y)
+    {
+        for(int x = 0; x < 16; ++x)
+        {
+            p.assign(x + 1/64.0, y + 1/64.0);
+            shifted.evaluate(x, y, e);
+            EXPECT_EQ(shifted.inside(e), inside<2>(p, triangle.columnView(0),
+                                                   triangle.columnView(1),
+                                                   triangle.columnView(2)));
+        }
+    }
+
+    // Stepping gives the same values as evaluating
+    long long stepped[3];
+    edges.evaluate(2, 3, stepped);
+    edges.stepX(stepped);
+    edges.stepY(stepped);
+    edges.evaluate(3, 4, e);
+    EXPECT_TRUE(std::equal(e, e + 3, stepped));
+
+    Matrix<2,3> line({0, 1, 2,
+                      0, 1, 2});
+    EXPECT_TRUE(EdgeFunctions<3>(line).isEmpty());
+}
+
+TEST_F(GeometryUnittest, edge_functions_shared_edge_valid)
+{
+    // A square split along its diagonal (in both vertex orders), every
+    // pixel in it (including those on the diagonal) is drawn once, and
+    // of the pixels on its sides only those on the left and top ones
+    int counts[16][16] = {};
+
+    cover(Matrix<2,3>({2, 12, 12,
+                       2,  2, 12}), counts);
+    cover(Matrix<2,3>({2,  2, 12,
+                       2, 12, 12}), counts);    // clockwise
+
+    for(int y = 0; y < 16; ++y)
+        for(int x = 0; x < 16; ++x)
+            EXPECT_EQ(counts[y][x], (x >= 2 && x < 12 && y > 2 && y <= 12) ? 1 : 0)
+                << x << "," << y;
+}
+
+TEST_F(GeometryUnittest, edge_functions_coverage_valid)
+{
+    Matrix<2,4> quad({-3.5, 17.25, 12,   -6,
+                      -2,    1.5,  19.75, 9});
+    EdgeFunctions<4> edges(quad);
+    long long row[4], e[4], single[4];
+
+    // Each bit of the batch mask matches the per pixel test
+    edges.evaluate(-8, -4, row);
+    for(int y = -4; y < 24; ++y, edges.stepY(row))
+    {
+        std::copy(row, row + 4, e);
+        for(int x = -8; x < 24; x += edges.BATCH, edges.stepX(e, edges.BATCH))
+        {
+            unsigned int mask = edges.coverage(e);
+
+            std::copy(e, e + 4, single);
+            for(int k = 0; k < edges.BATCH; ++k, edges.stepX(single))
+                EXPECT_EQ((mask >> k) & 1, edges.inside(single) ? 1u : 0u)
+                    << x + k << "," << y;
+        }
+    }
+}
+
+TEST_F(GeometryUnittest, clip_polygon_valid)
+{
+    Matrix<2,2> window({-10, 10,
+                        -5,  5});
+    Matrix<2,7> clipped;
+
+    // Inside
+    Matrix<2,3> inner({0, 4, 1,
+                       0, 1, 3});
+    EXPECT_EQ(clipPolygon<3>(inner, window, &clipped), 3);
+    EXPECT_EQ((Matrix<2,3>(clipped.blockView<2,3>(0,0))), inner);
+    EXPECT_EQ(clipped.getColumn(6), inner.getColumn(2));
+
+    // Outside
+    Matrix<2,3> outer({20, 30, 25,
+                        0,  1,  3});
+    EXPECT_EQ(clipPolygon<3>(outer, window, &clipped), 0);
+
+    // A triangle that covers the window is clipped to it
+    Matrix<2,3> big({-100, 100,   0,
+                     -100, -100, 100});
+    int count = clipPolygon<3>(big, window, &clipped);
+    EXPECT_EQ(count, 4);
+    EXPECT_EQ(getBounds(clipped), window);
+
+    // The repeated vertices don't affect the edge functions
+    EdgeFunctions<7> edges(clipped);
+    long long e[7];
+    edges.evaluate(-10, 0, e);
+    EXPECT_TRUE(edges.inside(e));    // a left edge
+    edges.evaluate(10, 0, e);
+    EXPECT_FALSE(edges.inside(e));   // a right edge
+    edges.evaluate(3, 4, e);
+    EXPECT_TRUE(edges.inside(e));
+
+    // A corner is cut off (one vertex becomes two)
+    Matrix<2,3> corner({0, 14, 0,
+                        0,  0, 4});
+    EXPECT_EQ(clipPolygon<3>(corner, window, &clipped), 4);
+    EXPECT_DOUBLE_EQ(area<2>(clipped.getColumn(0), clipped.getColumn(1), clipped.getColumn(2)) +
+                     area<2>(clipped.getColumn(0), clipped.getColumn(2), clipped.getColumn(3)),
+                     28 - 0.5 * 4 * (4.0 / 14 * 4));
+}
+
+TEST_F(GeometryUnittest, clip_polygon_shared_edge_valid)
+{
+    // Two triangles that share the edge from (-3,-1) to (17,6) are clipped
+    // to the same point on it (bit for bit, so the comparison is exact
+    // rather than Matrix's tolerance ==)
+    Matrix<2,2> window({-10, 10,
+                        -5,  5});
+    Matrix<2,3> one({-3, 17, -3,
+                     -1,  6,  4});
+    Matrix<2,3> two({17, -3, 14,
+                      6, -1, -2});
+    Matrix<2,7> a, b;
+
+    clipPolygon<3>(one, window, &a);
+    clipPolygon<3>(two, window, &b);
+
+    bool shared = false;
+    for(int i = 0; i < 7; ++i)
+        for(int j = 0; j < 7; ++j)
+            if(a(0,i) == 10 && a(0,i) == b(0,j) && a(1,i) == b(1,j))
+                shared = true;
+    EXPECT_TRUE(shared);
+}
+
+TEST_F(GeometryUnittest, clip_line_valid)
+{
+    Matrix<2,2> window({-10, 10,
+                        -5,  5});
+    Vector<2> p, q;
+
+    p = {-20, 0};
+    q = {20, 2};
+    EXPECT_TRUE(clipLine<2>(p, q, window));
+    EXPECT_EQ(p, (Matrix<2,1>(-10, 0.5)));
+    EXPECT_EQ(q, (Matrix<2,1>(10, 1.5)));
+
+    p = {1, 1};
+    q = {2, -3};
+    EXPECT_TRUE(clipLine<2>(p, q, window));
+    EXPECT_EQ(q, (Matrix<2,1>(2, -3)));
+
+    p = {-20, 6};
+    q = {20, 7};
+    EXPECT_FALSE(clipLine<2>(p, q, window));
+    EXPECT_EQ(p, (Matrix<2,1>(-20, 6)));
+}
+
+TEST_F(GeometryUnittest, intersect_segments_valid)
+{
+    std::vector< Matrix<2,2> > segments;
+    double alpha, beta;
+
+    segments.push_back(Matrix<2,2>({0, 4,
+                                    0, 4}));
+    segments.push_back(Matrix<2,2>({0, 4,
+                                    3, 1}));
+    segments.push_back(Matrix<2,2>({5, 6,
+                                    0, 1}));
+
+    std::vector<SegmentIntersection> found = intersectSegments<2>(segments);
+    ASSERT_EQ(1u, found.size());
+    EXPECT_EQ(0, found[0].first);
+    EXPECT_EQ(1, found[0].second);
+
+    intersect<2>(segments[0].getColumn(0), segments[0].getColumn(1),
+                 segments[1].getColumn(0), segments[1].getColumn(1),
+                 alpha, beta);
+    EXPECT_EQ(alpha, found[0].alpha);
+    EXPECT_EQ(beta, found[0].beta);
+}
+
+TEST_F(GeometryUnittest, intersect_segments_degenerate_valid)
+{
+    std::vector< Matrix<2,2> > segments;
+
+    // Three segments through (4/3, 4/3), which isn't representable,
+    // one of them twice, and a horizontal segment that ends on one
+    segments.push_back(Matrix<2,2>({0, 2,
+                                    0, 2}));
+    segments.push_back(Matrix<2,2>({0, 2,
+                                    2, 1}));
+    segments.push_back(Matrix<2,2>({1, 2,
+                                    2, 0}));
+    segments.push_back(Matrix<2,2>({2, 1,
+                                    0, 2}));
+    segments.push_back(Matrix<2,2>({2, 1,
+                                    1, 1}));
+
+    std::set< std::pair<int,int> > pairs;
+    for(const SegmentIntersection& found : intersectSegments<2>(segments))
+        pairs.insert(std::make_pair(found.first, found.second));
+
+    // Everything but the collinear pair (2, 3)
+    std::set< std::pair<int,int> > expected = {{0,1}, {0,2}, {0,3}, {0,4},
+                                               {1,2}, {1,3}, {1,4},
+                                               {2,4}, {3,4}};
+    EXPECT_EQ(expected, pairs);
+}
+
+TEST_F(GeometryUnittest, intersect_segments_brute_force_valid)
+{
+    std::vector< Matrix<2,2> > segments;
+    unsigned int seed = 1;
+
+    // Endpoints on a small grid (so that there are many shared
+    // endpoints, vertical segments and multiple intersections)
+    for(int i = 0; i < 60; ++i)
+    {
+        double v[4];
+        for(int k = 0; k < 4; ++k)
+        {
+            seed = seed * 1103515245u + 12345u;
+            v[k] = (seed >> 16) % 7;
+        }
+        segments.push_back(Matrix<2,2>({v[0], v[1],
+                                        v[2], v[3]}));
+    }
+
+    std::set< std::pair<int,int> > pairs, expected;
+    for(const SegmentIntersection& found : intersectSegments<2>(segments))
+        EXPECT_TRUE(pairs.insert(std::make_pair(found.first, found.second)).second);
+
+    for(int i = 0; i < 60; ++i)
+        for(int j = i + 1; j < 60; ++j)
+        {
+            Matrix<2,1> p = segments[i].getColumn(0), q = segments[i].getColumn(1);
+            Matrix<2,1> r = segments[j].getColumn(0), s = segments[j].getColumn(1);
+            double alpha, beta;
+
+            if(p != q && r != s && intersect<2>(p, q, r, s, alpha, beta) &&
+               alpha >= 0.0 && alpha <= 1.0 && beta >= 0.0 && beta <= 1.0)
+                expected.insert(std::make_pair(i, j));
+        }
+    EXPECT_EQ(expected, pairs);
+}
+
+TEST_F(GeometryUnittest, count_trailing_zeros_valid)
+{
+    EXPECT_EQ(countTrailingZeros(1u), 0);
+    EXPECT_EQ(countTrailingZeros(0xB8u), 3);
+    EXPECT_EQ(countTrailingZeros(~0u), 0);
+    EXPECT_EQ(countTrailingZeros(1u << 31), 31);
+    for(int i = 0; i < 32; ++i)
+        EXPECT_EQ(countTrailingZeros((~0u) << i), i);
+}
+
+TEST_F(GeometryUnittest, line_stepper_valid)
+{
+    // From (-3, -1) to (3, 2), y = (x + 1) / 2, so the pixels at odd x
+    // are halves, which are rounded away from zero
+    LineStepper<2> line(Matrix<2,1>(3, 2), Matrix<2,1>(-3, -1));
+    int expected[7] = {-1, -1, 0, 1, 1, 2, 2};
+
+    EXPECT_TRUE(line.isXMajor());
+    line.start(-3);
+    for(int x = -3; x <= 3; ++x, line.step())
+        EXPECT_EQ(expected[x + 3], line.getMinor());
+
+    // A steep line is stepped along y
+    LineStepper<2> steep(Matrix<2,1>(0, 0), Matrix<2,1>(1, 5));
+    int column[6] = {0, 0, 0, 1, 1, 1};
+
+    EXPECT_FALSE(steep.isXMajor());
+    steep.start(0);
+    for(int y = 0; y <= 5; ++y, steep.step())
+        EXPECT_EQ(column[y], steep.getMinor());
+}
+
+TEST_F(GeometryUnittest, line_stepper_subpixel_valid)
+{
+    // y = 0.25 + 0.375 (x - 0.5)
+    LineStepper<2> line(Matrix<2,1>(0.5, 0.25), Matrix<2,1>(8.5, 3.25));
+
+    line.start(1);
+    for(int x = 1; x <= 8; ++x, line.step())
+        EXPECT_EQ((int)std::round(0.25 + 0.375 * (x - 0.5)), line.getMinor());
+
+    // A point is a single pixel
+    LineStepper<2> point(Matrix<2,1>(2.5, -1.5), Matrix<2,1>(2.5, -1.5));
+    point.start(3);
+    EXPECT_EQ(-2, point.getMinor());
+}
+
+/**
+ * Check that the spans of an EdgeTable are the pixels that
+ * EdgeFunctions finds inside a polygon (in and around [-10, 45] x
+ * [-10, 35])
+ */
+template <int N>
+static void expectSameSpans(const Matrix<2,N>& polygon)
+{
+    EdgeFunctions<N> edges(polygon);
+    EdgeTable<N>     table(polygon);
+    long long        e[N];
+    int              left = 0, right = -1;
+
+    table.start(-10);
+    for(int y = -10; y <= 35; ++y, table.step())
+    {
+        bool span = table.getSpan(&left, &right);
+
+        for(int x = -10; x <= 45; ++x)
+        {
+            edges.evaluate(x, y, e);
+            EXPECT_EQ(edges.inside(e), span && x >= left && x <= right)
+                << "at (" << x << ", " << y << ")";
+        }
+    }
+}
+
+TEST_F(GeometryUnittest, edge_table_valid)
+{
+    // A thin diagonal triangle
+    expectSameSpans(Matrix<2,3>({0, 40, 41,
+                                 0, 30, 29}));
+
+    // A quadrilateral with horizontal edges on rows
+    expectSameSpans(Matrix<2,4>({-6, 5, 8, -3,
+                                 -4, -4, 7, 7}));
+
+    // A triangle with subpixel vertices (in the other order)
+    expectSameSpans(Matrix<2,3>({-2.75, 1.25, 9.5,
+                                 -3.5, 8.875, 0.125}));
+
+    // A clipped triangle (padded with a repeated vertex)
+    Matrix<2,2> window({-5.5, 5.5,
+                        -4.5, 4.5});
+    Matrix<2,7> clipped;
+    clipPolygon<3>(Matrix<2,3>({-9, 12, 2,
+                                -2, 0, 9}), window, &clipped);
+    expectSameSpans(clipped);
+}
@@ -0,0 +1,84 @@
+/**
+ * Line drawing benchmark
+ *
+ * Compares the two ways Rasterizer2D::drawLine() can find the pixels of
+ * a line: the parametric approach (a division per pixel) and the
+ * incremental approach (LineStepper, integer additions). The lines are
+ * drawn by the Rasterizer2D itself, into a FrameBuffer without a window
+ * (which discards the pixels), so that SDL isn't what is timed. The rate
+ * is reported in lines per second.
+ *
+ * Build with, for example:
+ *
+ *   g++ -std=c++17 -O2 Line_bench.cpp Rasterizer2D.cpp FrameBuffer.cpp \
+ *       -lbenchmark -lpthread -lSDL2
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+#include "FrameBuffer.h"
+#include "Rasterizer2D.h"
+
+static const int LINES = 1024;
+
+// Large enough that none of the lines is clipped
+static const int SIZE = 2048;
+
+/**
+ * Create LINES lines of (about) the given length in random directions
+ *
+ * @param length   The length (in pixels)
+ * @param whole    true for end points at whole pixels
+ * @return         The end points (one line after another)
+ */
+static std::vector< Matrix<2,1> > sample(int length, bool whole)
+{
+    std::vector< Matrix<2,1> > points;
+    unsigned int               seed = 1;
+
+    for (int i = 0; i < LINES; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        double angle = (seed >> 8) * (6.283185307179586 / (1 << 24));
+        double px = (i % 32) * 7.25, py = (i / 32) * 5.5;
+        double qx = px + length * std::cos(angle);
+        double qy = py + length * std::sin(angle);
+
+        if (whole)
+            px = std::round(px), py = std::round(py),
+            qx = std::round(qx), qy = std::round(qy);
+
+        points.push_back(Matrix<2,1>({px, py}));
+        points.push_back(Matrix<2,1>({qx, qy}));
+    }
+
+    return points;
+}
+
+static void BM_Line(benchmark::State& state, int technique)
+{
+    std::vector< Matrix<2,1> > points = sample(state.range(0), state.range(1) != 0);
+    FrameBuffer                fb(NULL, SIZE, SIZE);
+    Rasterizer2D               rasterizer(&fb);
+    Color                      color = {255, 255, 255};
+
+    rasterizer.setLineTechnique(technique);
+    for (auto _ : state)
+    {
+        for (int i = 0; i < LINES; ++i)
+            rasterizer.drawLine(points[2*i], points[2*i + 1], color);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * LINES);
+}
+BENCHMARK_CAPTURE(BM_Line, parametric, Rasterizer2D::PARAMETRIC)
+    ->ArgNames({"length", "whole"})->ArgsProduct({{8, 64, 512}, {1, 0}});
+BENCHMARK_CAPTURE(BM_Line, incremental, Rasterizer2D::INCREMENTAL)
+    ->ArgNames({"length", "whole"})->ArgsProduct({{8, 64, 512}, {1, 0}});
+
+BENCHMARK_MAIN();
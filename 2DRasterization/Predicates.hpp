@@ -0,0 +1,718 @@
+/**
+ * Robust geometric predicates
+ *
+ * author: Wooyoung Chung
+ *
+ */
+
+#ifndef __PREDICATES_HPP__
+#define __PREDICATES_HPP__
+
+#include <cmath>
+#include "../Matrix/Matrix.hpp"
+
+/**
+ * Adaptive precision versions of the orientation and incircle tests
+ * (after J. R. Shewchuk, "Adaptive Precision Floating-Point Arithmetic
+ * and Fast Robust Geometric Predicates", 1997).
+ *
+ * Each predicate first evaluates its determinant in plain double
+ * arithmetic and compares it to an error bound. Only when the result is
+ * too close to 0 to trust is it re-evaluated with exact (expansion)
+ * arithmetic, so the sign of the result is always correct but the
+ * common case costs little more than the plain determinant.
+ *
+ * orient2d(a, b, c)     > 0 if a, b, c are in counterclockwise order,
+ *                       < 0 if they are in clockwise order and
+ *                       = 0 if they are collinear
+ * incircle(a, b, c, d)  > 0 if d is inside the circle through the
+ *                       counterclockwise a, b, c, < 0 if it is outside
+ *                       and = 0 if it is on it
+ * cross2d(a, b, c, d)   The sign of (b - a) x (d - c) (which is 0 if
+ *                       the lines through a, b and c, d are parallel)
+ *
+ * The points are either arrays of two doubles or any 2x1 expression
+ * (e.g., a Vector<2> or a view of a column of a Matrix<2,N>). All of the
+ * work is done on the stack (nothing is allocated).
+ *
+ * Note: The exact arithmetic relies on every operation being rounded to
+ * double (i.e., SSE2, not the x87 FPU, and not -ffast-math). When the
+ * target has a fused multiply-add (e.g., -mfma), the compiler may fuse
+ * a product with a sum, which would break Dekker's splitting. So, the
+ * roundoff of a product is calculated with fma() instead (which is
+ * also faster).
+ */
+
+#if defined(__FP_FAST_FMA) || defined(FP_FAST_FMA)
+#define PREDICATE_FMA
+#endif
+
+
+// Error bounds (in units of the magnitude of the terms of the determinant,
+// see Shewchuk's paper)
+static constexpr double PREDICATE_EPSILON   = 1.1102230246251565e-16; // 2^-53
+static constexpr double PREDICATE_SPLITTER  = 134217729.0;           // 2^27 + 1
+static constexpr double PREDICATE_RESULT_ERRBOUND =
+    (3.0 + 8.0 * PREDICATE_EPSILON) * PREDICATE_EPSILON;
+static constexpr double PREDICATE_CCW_ERRBOUND_A =
+    (3.0 + 16.0 * PREDICATE_EPSILON) * PREDICATE_EPSILON;
+static constexpr double PREDICATE_CCW_ERRBOUND_B =
+    (2.0 + 12.0 * PREDICATE_EPSILON) * PREDICATE_EPSILON;
+static constexpr double PREDICATE_CCW_ERRBOUND_C =
+    (9.0 + 64.0 * PREDICATE_EPSILON) * PREDICATE_EPSILON * PREDICATE_EPSILON;
+static constexpr double PREDICATE_ICC_ERRBOUND_A =
+    (10.0 + 96.0 * PREDICATE_EPSILON) * PREDICATE_EPSILON;
+static constexpr double PREDICATE_ICC_ERRBOUND_B =
+    (4.0 + 48.0 * PREDICATE_EPSILON) * PREDICATE_EPSILON;
+
+
+// Expansion arithmetic
+//
+// An expansion is an array of doubles, ordered by increasing magnitude
+// and without overlapping bits, whose (exact) sum is the value. The
+// sign of an expansion is the sign of its last (largest) element.
+
+/**
+ * x + y = a + b exactly, where x = fl(a + b) (requires |a| >= |b|)
+ */
+inline void predicate_fast_two_sum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    double bvirt = x - a;
+    y = b - bvirt;
+}
+
+/**
+ * x + y = a + b exactly, where x = fl(a + b)
+ */
+inline void predicate_two_sum(double a, double b, double& x, double& y)
+{
+    x = a + b;
+    double bvirt  = x - a;
+    double avirt  = x - bvirt;
+    double bround = b - bvirt;
+    double around = a - avirt;
+    y = around + bround;
+}
+
+/**
+ * The roundoff error, y, of x = fl(a - b) (i.e., x + y = a - b exactly)
+ */
+inline double predicate_two_diff_tail(double a, double b, double x)
+{
+    double bvirt  = a - x;
+    double avirt  = x + bvirt;
+    double bround = bvirt - b;
+    double around = a - avirt;
+    return around + bround;
+}
+
+/**
+ * x + y = a - b exactly, where x = fl(a - b)
+ */
+inline void predicate_two_diff(double a, double b, double& x, double& y)
+{
+    x = a - b;
+    y = predicate_two_diff_tail(a, b, x);
+}
+
+/**
+ * Split a into two (26 bit) halves, hi + lo = a
+ */
+inline void predicate_split(double a, double& hi, double& lo)
+{
+    double c    = PREDICATE_SPLITTER * a;
+    double abig = c - a;
+    hi = c - abig;
+    lo = a - hi;
+}
+
+/**
+ * x + y = a * b exactly, where x = fl(a * b) (and b has been split)
+ */
+inline void predicate_two_product_presplit(double a, double b,
+                                           [[maybe_unused]] double bhi,
+                                           [[maybe_unused]] double blo,
+                                           double& x, double& y)
+{
+    x = a * b;
+#ifdef PREDICATE_FMA
+    y = std::fma(a, b, -x);
+#else
+    double ahi, alo;
+
+    predicate_split(a, ahi, alo);
+    double err1 = x - (ahi * bhi);
+    double err2 = err1 - (alo * bhi);
+    double err3 = err2 - (ahi * blo);
+    y = (alo * blo) - err3;
+#endif
+}
+
+/**
+ * x + y = a * b exactly, where x = fl(a * b)
+ */
+inline void predicate_two_product(double a, double b, double& x, double& y)
+{
+    double bhi = 0.0, blo = 0.0;
+
+#ifndef PREDICATE_FMA
+    predicate_split(b, bhi, blo);
+#endif
+    predicate_two_product_presplit(a, b, bhi, blo, x, y);
+}
+
+/**
+ * x = (a1 + a0) - (b1 + b0) exactly, as a four element expansion
+ */
+inline void predicate_two_two_diff(double a1, double a0, double b1, double b0,
+                                   double x[4])
+{
+    double i, j, k;
+
+    // (a1 + a0) - b0
+    predicate_two_diff(a0, b0, i, x[0]);
+    predicate_two_sum(a1, i, j, k);
+
+    // (j + k) - b1
+    predicate_two_diff(k, b1, i, x[1]);
+    predicate_two_sum(j, i, x[3], x[2]);
+}
+
+/**
+ * Sum two expansions (eliminating the zero elements)
+ *
+ * @param elen   The length of e
+ * @param e      One expansion
+ * @param flen   The length of f
+ * @param f      The other expansion
+ * @param h      The sum (at least elen + flen elements, may not be e or f)
+ * @return       The length of h
+ */
+inline int predicate_expansion_sum(int elen, const double* e,
+                                   int flen, const double* f, double* h)
+{
+    double q, qnew, hh;
+    double enow = e[0], fnow = f[0];
+    int    eindex = 0, findex = 0, hindex = 0;
+
+    // Take the elements in order of increasing magnitude
+    if ((fnow > enow) == (fnow > -enow))
+    {
+        q    = enow;
+        enow = (++eindex < elen) ? e[eindex] : 0.0;
+    }
+    else
+    {
+        q    = fnow;
+        fnow = (++findex < flen) ? f[findex] : 0.0;
+    }
+
+    if ((eindex < elen) && (findex < flen))
+    {
+        if ((fnow > enow) == (fnow > -enow))
+        {
+            predicate_fast_two_sum(enow, q, qnew, hh);
+            enow = (++eindex < elen) ? e[eindex] : 0.0;
+        }
+        else
+        {
+            predicate_fast_two_sum(fnow, q, qnew, hh);
+            fnow = (++findex < flen) ? f[findex] : 0.0;
+        }
+        q = qnew;
+        if (hh != 0.0)
+            h[hindex++] = hh;
+
+        while ((eindex < elen) && (findex < flen))
+        {
+            if ((fnow > enow) == (fnow > -enow))
+            {
+                predicate_two_sum(q, enow, qnew, hh);
+                enow = (++eindex < elen) ? e[eindex] : 0.0;
+            }
+            else
+            {
+                predicate_two_sum(q, fnow, qnew, hh);
+                fnow = (++findex < flen) ? f[findex] : 0.0;
+            }
+            q = qnew;
+            if (hh != 0.0)
+                h[hindex++] = hh;
+        }
+    }
+
+    while (eindex < elen)
+    {
+        predicate_two_sum(q, enow, qnew, hh);
+        enow = (++eindex < elen) ? e[eindex] : 0.0;
+        q = qnew;
+        if (hh != 0.0)
+            h[hindex++] = hh;
+    }
+    while (findex < flen)
+    {
+        predicate_two_sum(q, fnow, qnew, hh);
+        fnow = (++findex < flen) ? f[findex] : 0.0;
+        q = qnew;
+        if (hh != 0.0)
+            h[hindex++] = hh;
+    }
+
+    if ((q != 0.0) || (hindex == 0))
+        h[hindex++] = q;
+
+    return hindex;
+}
+
+/**
+ * Multiply an expansion by a double (eliminating the zero elements)
+ *
+ * @param elen   The length of e
+ * @param e      The expansion
+ * @param b      The double
+ * @param h      The product (at least 2 * elen elements, may not be e)
+ * @return       The length of h
+ */
+inline int predicate_scale_expansion(int elen, const double* e, double b,
+                                     double* h)
+{
+    double q, sum, hh, product1, product0;
+    double bhi = 0.0, blo = 0.0;
+    int    hindex = 0;
+
+#ifndef PREDICATE_FMA
+    predicate_split(b, bhi, blo);
+#endif
+    predicate_two_product_presplit(e[0], b, bhi, blo, q, hh);
+    if (hh != 0.0)
+        h[hindex++] = hh;
+
+    for (int eindex = 1; eindex < elen; ++eindex)
+    {
+        predicate_two_product_presplit(e[eindex], b, bhi, blo,
+                                       product1, product0);
+        predicate_two_sum(q, product0, sum, hh);
+        if (hh != 0.0)
+            h[hindex++] = hh;
+        predicate_fast_two_sum(product1, sum, q, hh);
+        if (hh != 0.0)
+            h[hindex++] = hh;
+    }
+
+    if ((q != 0.0) || (hindex == 0))
+        h[hindex++] = q;
+
+    return hindex;
+}
+
+/**
+ * Approximate the value of an expansion (with the correct sign)
+ */
+inline double predicate_estimate(int elen, const double* e)
+{
+    double q = e[0];
+
+    for (int i = 1; i < elen; ++i)
+        q += e[i];
+
+    return q;
+}
+
+/**
+ * Negate an expansion (in place)
+ */
+inline void predicate_negate(int elen, double* e)
+{
+    for (int i = 0; i < elen; ++i)
+        e[i] = -e[i];
+}
+
+/**
+ * Calculate the exact value of orient2d(a, b, c) from the original
+ * coordinates (i.e., ax by - ax cy + bx cy - bx ay + cx ay - cx by)
+ *
+ * @param h   The value (at least 12 elements)
+ * @return    The length of h
+ */
+inline int predicate_orient2d_exact(const double* pa, const double* pb,
+                                    const double* pc, double* h)
+{
+    double hi1, lo1, hi2, lo2;
+    double aterms[4], bterms[4], cterms[4], v[8];
+
+    predicate_two_product(pa[0], pb[1], hi1, lo1);
+    predicate_two_product(pa[0], pc[1], hi2, lo2);
+    predicate_two_two_diff(hi1, lo1, hi2, lo2, aterms);
+
+    predicate_two_product(pb[0], pc[1], hi1, lo1);
+    predicate_two_product(pb[0], pa[1], hi2, lo2);
+    predicate_two_two_diff(hi1, lo1, hi2, lo2, bterms);
+
+    predicate_two_product(pc[0], pa[1], hi1, lo1);
+    predicate_two_product(pc[0], pb[1], hi2, lo2);
+    predicate_two_two_diff(hi1, lo1, hi2, lo2, cterms);
+
+    int vlen = predicate_expansion_sum(4, aterms, 4, bterms, v);
+    return predicate_expansion_sum(vlen, v, 4, cterms, h);
+}
+
+/**
+ * The adaptive stages of orient2d() (when the plain determinant is too
+ * close to 0 to trust)
+ *
+ * @param detsum   The sum of the magnitudes of the two products
+ */
+inline double predicate_orient2d_adapt(const double* pa, const double* pb,
+                                       const double* pc, double detsum)
+{
+    double acx = pa[0] - pc[0];
+    double bcx = pb[0] - pc[0];
+    double acy = pa[1] - pc[1];
+    double bcy = pb[1] - pc[1];
+    double detleft, detlefttail, detright, detrighttail;
+    double s1, s0, t1, t0;
+    double b[4], u[4], c1[8], c2[12], d[16];
+
+    // Stage B: the exact determinant of the (rounded) differences
+    predicate_two_product(acx, bcy, detleft, detlefttail);
+    predicate_two_product(acy, bcx, detright, detrighttail);
+    predicate_two_two_diff(detleft, detlefttail, detright, detrighttail, b);
+
+    double det      = predicate_estimate(4, b);
+    double errbound = PREDICATE_CCW_ERRBOUND_B * detsum;
+    if ((det >= errbound) || (-det >= errbound))
+        return det;
+
+    double acxtail = predicate_two_diff_tail(pa[0], pc[0], acx);
+    double bcxtail = predicate_two_diff_tail(pb[0], pc[0], bcx);
+    double acytail = predicate_two_diff_tail(pa[1], pc[1], acy);
+    double bcytail = predicate_two_diff_tail(pb[1], pc[1], bcy);
+
+    // The differences were exact, so b is the exact determinant
+    if ((acxtail == 0.0) && (acytail == 0.0) &&
+        (bcxtail == 0.0) && (bcytail == 0.0))
+        return det;
+
+    // Stage C: a first order correction for the roundoff in the differences
+    errbound = PREDICATE_CCW_ERRBOUND_C * detsum +
+               PREDICATE_RESULT_ERRBOUND * std::fabs(det);
+    det += (acx * bcytail + bcy * acxtail) - (acy * bcxtail + bcx * acytail);
+    if ((det >= errbound) || (-det >= errbound))
+        return det;
+
+    // Stage D: exact
+    predicate_two_product(acxtail, bcy, s1, s0);
+    predicate_two_product(acytail, bcx, t1, t0);
+    predicate_two_two_diff(s1, s0, t1, t0, u);
+    int c1len = predicate_expansion_sum(4, b, 4, u, c1);
+
+    predicate_two_product(acx, bcytail, s1, s0);
+    predicate_two_product(acy, bcxtail, t1, t0);
+    predicate_two_two_diff(s1, s0, t1, t0, u);
+    int c2len = predicate_expansion_sum(c1len, c1, 4, u, c2);
+
+    predicate_two_product(acxtail, bcytail, s1, s0);
+    predicate_two_product(acytail, bcxtail, t1, t0);
+    predicate_two_two_diff(s1, s0, t1, t0, u);
+    int dlen = predicate_expansion_sum(c2len, c2, 4, u, d);
+
+    return d[dlen - 1];
+}
+
+/**
+ * Calculate the exact value of incircle(a, b, c, d) from the original
+ * coordinates (i.e., the 4x4 determinant with rows x, y, x^2 + y^2, 1)
+ */
+inline double predicate_incircle_exact(const double* pa, const double* pb,
+                                       const double* pc, const double* pd)
+{
+    double ab[4], bc[4], cd[4], da[4], ac[4], bd[4];
+    double temp8[8], abc[12], bcd[12], cda[12], dab[12];
+    double det24x[24], det24y[24], det48x[48], det48y[48];
+    double adet[96], bdet[96], cdet[96], ddet[96];
+    double abdet[192], cddet[192], deter[384];
+    double hi1, lo1, hi2, lo2;
+
+    // The 2x2 minors of the x and y rows
+    const double* points[4] = {pa, pb, pc, pd};
+    double*       minors[6] = {ab, bc, cd, da, ac, bd};
+    const int     pairs[6][2] = {{0,1}, {1,2}, {2,3}, {3,0}, {0,2}, {1,3}};
+    for (int m = 0; m < 6; ++m)
+    {
+        const double* p = points[pairs[m][0]];
+        const double* q = points[pairs[m][1]];
+
+        predicate_two_product(p[0], q[1], hi1, lo1);
+        predicate_two_product(q[0], p[1], hi2, lo2);
+        predicate_two_two_diff(hi1, lo1, hi2, lo2, minors[m]);
+    }
+
+    // The 3x3 minors
+    int templen = predicate_expansion_sum(4, cd, 4, da, temp8);
+    int cdalen  = predicate_expansion_sum(templen, temp8, 4, ac, cda);
+    templen     = predicate_expansion_sum(4, da, 4, ab, temp8);
+    int dablen  = predicate_expansion_sum(templen, temp8, 4, bd, dab);
+    predicate_negate(4, bd);
+    predicate_negate(4, ac);
+    templen     = predicate_expansion_sum(4, ab, 4, bc, temp8);
+    int abclen  = predicate_expansion_sum(templen, temp8, 4, ac, abc);
+    templen     = predicate_expansion_sum(4, bc, 4, cd, temp8);
+    int bcdlen  = predicate_expansion_sum(templen, temp8, 4, bd, bcd);
+
+    // Each 3x3 minor times the lift (x^2 + y^2) of the remaining point
+    const double* minor3[4]  = {bcd, cda, dab, abc};
+    const int     len3[4]    = {bcdlen, cdalen, dablen, abclen};
+    double*       lifted[4]  = {adet, bdet, cdet, ddet};
+    int           liftlen[4];
+    for (int p = 0; p < 4; ++p)
+    {
+        int xlen  = predicate_scale_expansion(len3[p], minor3[p], points[p][0], det24x);
+        int xxlen = predicate_scale_expansion(xlen, det24x, points[p][0], det48x);
+        int ylen  = predicate_scale_expansion(len3[p], minor3[p], points[p][1], det24y);
+        int yylen = predicate_scale_expansion(ylen, det24y, points[p][1], det48y);
+        liftlen[p] = predicate_expansion_sum(xxlen, det48x, yylen, det48y, lifted[p]);
+    }
+    predicate_negate(liftlen[1], bdet);
+    predicate_negate(liftlen[3], ddet);
+
+    int ablen    = predicate_expansion_sum(liftlen[0], adet, liftlen[1], bdet, abdet);
+    int cdlen    = predicate_expansion_sum(liftlen[2], cdet, liftlen[3], ddet, cddet);
+    int deterlen = predicate_expansion_sum(ablen, abdet, cdlen, cddet, deter);
+
+    return deter[deterlen - 1];
+}
+
+/**
+ * The adaptive stages of incircle() (when the plain determinant is too
+ * close to 0 to trust)
+ *
+ * Note: Unlike Shewchuk's version, there is no first order correction
+ * stage, the exact determinant of the original coordinates is used when
+ * the differences aren't exact (which is rare for pixel coordinates).
+ *
+ * @param permanent   The sum of the magnitudes of the terms
+ */
+inline double predicate_incircle_adapt(const double* pa, const double* pb,
+                                       const double* pc, const double* pd,
+                                       double permanent)
+{
+    double adx = pa[0] - pd[0], ady = pa[1] - pd[1];
+    double bdx = pb[0] - pd[0], bdy = pb[1] - pd[1];
+    double cdx = pc[0] - pd[0], cdy = pc[1] - pd[1];
+    double hi1, lo1, hi2, lo2;
+    double minor[4], xterm[8], xxterm[16], yterm[8], yyterm[16];
+    double lifted[3][32], ab[64], fin[96];
+    int    liftlen[3];
+
+    // Stage B: the exact determinant of the (rounded) differences
+    const double dx[3] = {adx, bdx, cdx};
+    const double dy[3] = {ady, bdy, cdy};
+    for (int p = 0; p < 3; ++p)
+    {
+        int q = (p + 1) % 3, r = (p + 2) % 3;
+
+        predicate_two_product(dx[q], dy[r], hi1, lo1);
+        predicate_two_product(dx[r], dy[q], hi2, lo2);
+        predicate_two_two_diff(hi1, lo1, hi2, lo2, minor);
+
+        int xlen  = predicate_scale_expansion(4, minor, dx[p], xterm);
+        int xxlen = predicate_scale_expansion(xlen, xterm, dx[p], xxterm);
+        int ylen  = predicate_scale_expansion(4, minor, dy[p], yterm);
+        int yylen = predicate_scale_expansion(ylen, yterm, dy[p], yyterm);
+        liftlen[p] = predicate_expansion_sum(xxlen, xxterm, yylen, yyterm, lifted[p]);
+    }
+    int ablen  = predicate_expansion_sum(liftlen[0], lifted[0], liftlen[1], lifted[1], ab);
+    int finlen = predicate_expansion_sum(ablen, ab, liftlen[2], lifted[2], fin);
+
+    double det      = predicate_estimate(finlen, fin);
+    double errbound = PREDICATE_ICC_ERRBOUND_B * permanent;
+    if ((det >= errbound) || (-det >= errbound))
+        return det;
+
+    // The differences were exact, so fin is the exact determinant
+    if ((predicate_two_diff_tail(pa[0], pd[0], adx) == 0.0) &&
+        (predicate_two_diff_tail(pa[1], pd[1], ady) == 0.0) &&
+        (predicate_two_diff_tail(pb[0], pd[0], bdx) == 0.0) &&
+        (predicate_two_diff_tail(pb[1], pd[1], bdy) == 0.0) &&
+        (predicate_two_diff_tail(pc[0], pd[0], cdx) == 0.0) &&
+        (predicate_two_diff_tail(pc[1], pd[1], cdy) == 0.0))
+        return det;
+
+    return predicate_incircle_exact(pa, pb, pc, pd);
+}
+
+
+// Predicates
+
+/**
+ * Determine the orientation of three points
+ *
+ * @param pa   The first point (x, y)
+ * @param pb   The second point
+ * @param pc   The third point
+ * @return     A positive value if pa, pb, pc are in counterclockwise
+ *             order, a negative value if they are in clockwise order,
+ *             and 0 if they are collinear (approximately twice the
+ *             signed area of the triangle)
+ */
+inline double orient2d(const double* pa, const double* pb, const double* pc)
+{
+    double detleft  = (pa[0] - pc[0]) * (pb[1] - pc[1]);
+    double detright = (pa[1] - pc[1]) * (pb[0] - pc[0]);
+    double det      = detleft - detright;
+    double detsum;
+
+    // If the products have different signs (or one is 0) there is no
+    // cancellation, and the result is correct
+    if (detleft > 0.0)
+    {
+        if (detright <= 0.0)
+            return det;
+        detsum = detleft + detright;
+    }
+    else if (detleft < 0.0)
+    {
+        if (detright >= 0.0)
+            return det;
+        detsum = -detleft - detright;
+    }
+    else
+    {
+        return det;
+    }
+
+    double errbound = PREDICATE_CCW_ERRBOUND_A * detsum;
+    if ((det >= errbound) || (-det >= errbound))
+        return det;
+
+    return predicate_orient2d_adapt(pa, pb, pc, detsum);
+}
+
+/**
+ * Determine whether a point is inside the circle through three others
+ *
+ * @param pa   The first point on the circle (x, y)
+ * @param pb   The second point on the circle
+ * @param pc   The third point on the circle (pa, pb, pc must be in
+ *             counterclockwise order, the sign is reversed otherwise)
+ * @param pd   The point to test
+ * @return     A positive value if pd is inside the circle, a negative
+ *             value if it is outside and 0 if it is on it
+ */
+inline double incircle(const double* pa, const double* pb,
+                       const double* pc, const double* pd)
+{
+    double adx = pa[0] - pd[0], ady = pa[1] - pd[1];
+    double bdx = pb[0] - pd[0], bdy = pb[1] - pd[1];
+    double cdx = pc[0] - pd[0], cdy = pc[1] - pd[1];
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+    double alift  = adx * adx + ady * ady;
+    double blift  = bdx * bdx + bdy * bdy;
+    double clift  = cdx * cdx + cdy * cdy;
+
+    double det = alift * (bdxcdy - cdxbdy)
+               + blift * (cdxady - adxcdy)
+               + clift * (adxbdy - bdxady);
+
+    double permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * alift
+                     + (std::fabs(cdxady) + std::fabs(adxcdy)) * blift
+                     + (std::fabs(adxbdy) + std::fabs(bdxady)) * clift;
+    double errbound  = PREDICATE_ICC_ERRBOUND_A * permanent;
+    if ((det > errbound) || (-det > errbound))
+        return det;
+
+    return predicate_incircle_adapt(pa, pb, pc, pd, permanent);
+}
+
+/**
+ * Determine the sign of the cross product of two directions,
+ * (pb - pa) x (pd - pc) (e.g., to tell whether two lines are parallel)
+ *
+ * @param pa   The start of the first direction (x, y)
+ * @param pb   The end of the first direction
+ * @param pc   The start of the second direction
+ * @param pd   The end of the second direction
+ * @return     A value with the sign of the cross product (which is 0 if
+ *             and only if the directions are parallel)
+ */
+inline double cross2d(const double* pa, const double* pb,
+                      const double* pc, const double* pd)
+{
+    double left  = (pb[0] - pa[0]) * (pd[1] - pc[1]);
+    double right = (pb[1] - pa[1]) * (pd[0] - pc[0]);
+    double det   = left - right;
+
+    // Same form (and so the same error bound) as orient2d()
+    double errbound = PREDICATE_CCW_ERRBOUND_A * (std::fabs(left) + std::fabs(right));
+    if ((det > errbound) || (-det > errbound))
+        return det;
+
+    // (b - a) x (d - c) = orient2d(a, b, d) - orient2d(a, b, c)
+    double abd[12], abc[12], diff[24];
+    int    abdlen = predicate_orient2d_exact(pa, pb, pd, abd);
+    int    abclen = predicate_orient2d_exact(pa, pb, pc, abc);
+    predicate_negate(abclen, abc);
+    int    difflen = predicate_expansion_sum(abdlen, abd, abclen, abc, diff);
+
+    return diff[difflen - 1];
+}
+
+/**
+ * Determine the orientation of three points (given as 2x1 expressions)
+ *
+ * @param a   The first point
+ * @param b   The second point
+ * @param c   The third point
+ * @return    See orient2d() above
+ */
+template <class A, class B, class C>
+double orient2d(const MatrixExpression<A,2,1>& a, const MatrixExpression<B,2,1>& b,
+                const MatrixExpression<C,2,1>& c)
+{
+    const double pa[2] = {a.element(0,0), a.element(1,0)};
+    const double pb[2] = {b.element(0,0), b.element(1,0)};
+    const double pc[2] = {c.element(0,0), c.element(1,0)};
+
+    return orient2d(pa, pb, pc);
+}
+
+/**
+ * Determine whether a point is inside the circle through three others
+ * (given as 2x1 expressions)
+ *
+ * @return    See incircle() above
+ */
+template <class A, class B, class C, class D>
+double incircle(const MatrixExpression<A,2,1>& a, const MatrixExpression<B,2,1>& b,
+                const MatrixExpression<C,2,1>& c, const MatrixExpression<D,2,1>& d)
+{
+    const double pa[2] = {a.element(0,0), a.element(1,0)};
+    const double pb[2] = {b.element(0,0), b.element(1,0)};
+    const double pc[2] = {c.element(0,0), c.element(1,0)};
+    const double pd[2] = {d.element(0,0), d.element(1,0)};
+
+    return incircle(pa, pb, pc, pd);
+}
+
+/**
+ * Determine the sign of (b - a) x (d - c) (given as 2x1 expressions)
+ *
+ * @return    See cross2d() above
+ */
+template <class A, class B, class C, class D>
+double cross2d(const MatrixExpression<A,2,1>& a, const MatrixExpression<B,2,1>& b,
+               const MatrixExpression<C,2,1>& c, const MatrixExpression<D,2,1>& d)
+{
+    const double pa[2] = {a.element(0,0), a.element(1,0)};
+    const double pb[2] = {b.element(0,0), b.element(1,0)};
+    const double pc[2] = {c.element(0,0), c.element(1,0)};
+    const double pd[2] = {d.element(0,0), d.element(1,0)};
+
+    return cross2d(pa, pb, pc, pd);
+}
+
+#endif
@@ -12,6 +12,8 @@
 Rasterizer2D::Rasterizer2D(FrameBuffer *fb)
 {
     this->fb = fb;
+    this->fillTechnique = SCAN_LINE;
+    this->lineTechnique = PARAMETRIC;
 }
 
 void 
@@ -24,73 +26,130 @@ void
 Rasterizer2D::drawLine(const Matrix<2,1>& p, const Matrix<2,1>& q,
                             const Color& color)
 {
-    double x,y;
-    int xEnd, xStart, yEnd, yStart;
-    double alpha, slope;
-    //find slope here
-    if(q.get(0,0) == p.get(0,0))
-        slope = INFINITY;
-    else
-        slope = (q.get(1,0)-p.get(1,0))/(q.get(0,0) - p.get(0,0));
-    
-    if((slope >= -1.0) && (slope <= 1.0))
-        goto STDSLOPE;
+    //clip the line to the window (so that only visible pixels are drawn),
+    //grown by a pixel on each side since a rounded pixel of the line can
+    //be inside the window even when the line itself isn't
+    Matrix<2,2> window = getWindow();
+    window.assign(window.get<0,0>() - 1, window.get<0,1>() + 1,
+                  window.get<1,0>() - 1, window.get<1,1>() + 1);
+    Matrix<2,1> cp(p), cq(q);
+    if(!clipLine<2>(cp, cq, window))
+        return;
+
+    //step along the original line, but only across the clipped part of
+    //it (so that the pixels don't change when the line crosses the edge
+    //of the window), unless it is too long to step exactly
+    const double limit = LineStepper<2>::MAX_COORDINATE;
+    bool original = fabs(p.get<0,0>()) < limit && fabs(p.get<1,0>()) < limit &&
+                    fabs(q.get<0,0>()) < limit && fabs(q.get<1,0>()) < limit;
+    const Matrix<2,1>& a = original ? p : cp;
+    const Matrix<2,1>& b = original ? q : cq;
+
+    if(lineTechnique == INCREMENTAL)
+        incrementalLine(a, b, cp, cq, color);
     else
-        goto OTHERSLOPE;
+        parametricLine(a, b, cp, cq, color);
+}
 
-STDSLOPE:
-    if(p.get(0,0) <= q.get(0,0))
+/**
+ * Find the pixels (along the major axis) to draw: those of the line
+ * from u0 to u1 that are in the clipped part of it, from c0 to c1 (plus
+ * one on each side, which the FrameBuffer clips, so that roundoff in
+ * the clipping can't drop a visible pixel)
+ *
+ * @param u0     One end of the line
+ * @param u1     The other end of the line
+ * @param c0     One end of the clipped line
+ * @param c1     The other end of the clipped line
+ * @param first  The first pixel (returned)
+ * @param last   The last pixel (returned)
+ */
+static void
+getSteps(double u0, double u1, double c0, double c1, int* first, int* last)
+{
+    *first = std::max((int)round(std::fmin(u0, u1)), (int)floor(std::fmin(c0, c1)));
+    *last  = std::min((int)round(std::fmax(u0, u1)), (int)ceil(std::fmax(c0, c1)));
+}
+
+void
+Rasterizer2D::incrementalLine(const Matrix<2,1>& p, const Matrix<2,1>& q,
+                              const Matrix<2,1>& cp, const Matrix<2,1>& cq,
+                              const Color& color)
+{
+    LineStepper<2> line(p, q);
+    bool xMajor = line.isXMajor();
+    int k = xMajor ? 0 : 1;
+    int first, last;
+
+    getSteps(p.get(k,0), q.get(k,0), cp.get(k,0), cq.get(k,0), &first, &last);
+    if(first > last)
+        return;
+
+    line.start(first);
+    if(xMajor)
     {
-        xStart = round(p.get(0,0));
-        xEnd = round(q.get(0,0));
+        for (int i = first; i <= last; i++, line.step())
+            fb->setPixel(i, line.getMinor(), color);
     }
     else
     {
-        xStart = round(q.get(0,0));
-        xEnd = round(p.get(0,0));
+        for (int i = first; i <= last; i++, line.step())
+            fb->setPixel(line.getMinor(), i, color);
     }
+}
+
+void
+Rasterizer2D::parametricLine(const Matrix<2,1>& p, const Matrix<2,1>& q,
+                             const Matrix<2,1>& cp, const Matrix<2,1>& cq,
+                             const Color& color)
+{
+    double x,y;
+    double alpha, slope;
+    int first, last;
+    //read the end points once (the indexes are checked at compile time)
+    double px = p.get<0,0>(), py = p.get<1,0>();
+    double qx = q.get<0,0>(), qy = q.get<1,0>();
+    //find slope here
+    if(qx == px)
+        slope = INFINITY;
+    else
+        slope = (qy - py)/(qx - px);
 
-    for (int i = xStart; i <= xEnd; i++)
+    if((slope >= -1.0) && (slope <= 1.0))
     {
-        if(q.get(0,0) == p.get(0,0))
+        getSteps(px, qx, cp.get<0,0>(), cq.get<0,0>(), &first, &last);
+        for (int i = first; i <= last; i++)
         {
-            y = p.get(1,0);
-        }
-        else
-        {
-            alpha = (i - p.get(0,0)) / (q.get(0,0) - p.get(0,0));
-            y = p.get(1,0) + alpha * (q.get(1,0) - p.get(1,0));
-        }
-        
-        fb->setPixel(i, round(y), color);
-    }
-    return;
+            if(qx == px)
+            {
+                y = py;
+            }
+            else
+            {
+                alpha = (i - px) / (qx - px);
+                y = py + alpha * (qy - py);
+            }
 
-OTHERSLOPE:
-    if(p.get(1,0) <= q.get(1,0))
-    {
-        yStart = round(p.get(1,0));
-        yEnd = round(q.get(1,0));
+            fb->setPixel(i, round(y), color);
+        }
     }
     else
     {
-        yStart = round(q.get(1,0));
-        yEnd = round(p.get(1,0));
-    }
-
-    for (int i = yStart; i <= yEnd; i++)
-    {
-        if(q.get(1,0) == p.get(1,0))
-        {
-            x = p.get(0,0);
-        }
-        else
+        getSteps(py, qy, cp.get<1,0>(), cq.get<1,0>(), &first, &last);
+        for (int i = first; i <= last; i++)
         {
-            alpha = (i - p.get(1,0)) / (q.get(1,0) - p.get(1,0));
-            x = p.get(0,0) + alpha * (q.get(0,0) - p.get(0,0));
+            if(qy == py)
+            {
+                x = px;
+            }
+            else
+            {
+                alpha = (i - py) / (qy - py);
+                x = px + alpha * (qx - px);
+            }
+
+            fb->setPixel(round(x), i, color);
         }
-        
-        fb->setPixel(round(x), i, color);
     }
 }
 
@@ -103,7 +162,7 @@ Rasterizer2D::drawPoint(int x, int y, const Color& color)
 void
 Rasterizer2D::drawPoint(Matrix<2,1>& point, const Color& color)
 {
-    fb->setPixel(round(point.get(0,0)), round(point.get(1,0)), color);
+    fb->setPixel(round(point.get<0,0>()), round(point.get<1,0>()), color);
 }
 
 void
@@ -122,108 +181,234 @@ Rasterizer2D::drawTriangle(const Matrix<2,3> &triangle,
         drawLine(triangle.getColumn(i%3), triangle.getColumn((i+1)%3), color);
 }
 
+void
+Rasterizer2D::setLineTechnique(int technique)
+{
+    if(technique != PARAMETRIC && technique != INCREMENTAL)
+        throw std::invalid_argument("Rasterizer2D: unknown line technique");
+
+    this->lineTechnique = technique;
+}
+
+void
+Rasterizer2D::setFillTechnique(int technique)
+{
+    if(technique != SCAN_LINE && technique != POINTWISE)
+        throw std::invalid_argument("Rasterizer2D: unknown fill technique");
+
+    this->fillTechnique = technique;
+}
+
 void
 Rasterizer2D::fillQuadrilateral(const Matrix<2,4>& quad,
                                 const Color& color)
 {
-    pointwiseFillQuadrilateral(quad, color);
+    fillPolygon<4>(quad, color, fillTechnique);
 }
 
 void
 Rasterizer2D::fillTriangle(const Matrix<2,3>& triangle, 
                            const Color& color)
 {
-    pointwiseFillTriangle(triangle, color);
+    fillPolygon<3>(triangle, color, fillTechnique);
 }
 
 void
 Rasterizer2D::pointwiseFillQuadrilateral(const Matrix<2,4>& quad,
                                          const Color& color)
 {
-    //find bounding rect
-    Matrix<2,2> bound;
-    bound = getBounds(quad);
+    fillPolygon<4>(quad, color, POINTWISE);
+}
 
-    Vector<2> origin, testPoint;
-    origin = {0,0};
+void
+Rasterizer2D::pointwiseFillTriangle(const Matrix<2,3>& triangle,
+                                    const Color& color)
+{
+    fillPolygon<3>(triangle, color, POINTWISE);
+}
 
-    Vector<2> implicit[4];
-    double bs[4];
-    double sign[4];
+void
+Rasterizer2D::scanLineFillQuadrilateral(const Matrix<2,4>& quad,
+                                        const Color& color)
+{
+    fillPolygon<4>(quad, color, SCAN_LINE);
+}
 
-    //pre-calculate implicit form of each eadge
-    for(int i = 0; i < 4; ++i)
-         bs[i] = toImplicit<2>(quad.getColumn(i%4), quad.getColumn((i+1)%4), &implicit[i]);
+void
+Rasterizer2D::scanLineFillTriangle(const Matrix<2,3>& triangle,
+                                   const Color& color)
+{
+    fillPolygon<3>(triangle, color, SCAN_LINE);
+}
 
-    //store halfspace test result of next vertex
-    for(int i = 0; i < 4; ++i)
-        sign[i] = testHalfspace<2>(quad.getColumn((i+2)%4), implicit[i], bs[i]);
+/**
+ * Get the rectangle covered by the pixels of the FrameBuffer (whose
+ * origin is in the center), in the format returned by getBounds()
+ *
+ * @return   The rectangle
+ */
+Matrix<2,2>
+Rasterizer2D::getWindow() const
+{
+    //pixel (x,y) covers [x - 0.5, x + 0.5] x [y - 0.5, y + 0.5]
+    double xMax = fb->getWidth() / 2, yMax = fb->getHeight() / 2;
+
+    return Matrix<2,2>(-xMax - 0.5, xMax + 0.5,
+                       -yMax - 0.5, yMax + 0.5);
+}
 
-    for(int y = bound(1,0); y <= bound(1,1); y++)
+/**
+ * Find the whole pixels of a bounding rectangle that are in the window
+ *
+ * @param bound   The bounding rectangle (as returned by getBounds())
+ * @param window  The window (as returned by getWindow())
+ * @param pixels  The pixels (returned, in the same format)
+ * @return        false if there are none
+ */
+static bool
+getPixels(const Matrix<2,2>& bound, const Matrix<2,2>& window,
+          Matrix<2,2>* pixels)
+{
+    double xMin = ceil(std::fmax(bound.get<0,0>(), window.get<0,0>()));
+    double xMax = floor(std::fmin(bound.get<0,1>(), window.get<0,1>()));
+    double yMin = ceil(std::fmax(bound.get<1,0>(), window.get<1,0>()));
+    double yMax = floor(std::fmin(bound.get<1,1>(), window.get<1,1>()));
+
+    *pixels = Matrix<2,2>(xMin, xMax, yMin, yMax);
+    return xMin <= xMax && yMin <= yMax;
+}
+
+/**
+ * Fill a convex polygon, visiting only the part of its bounding
+ * rectangle that is in the window.
+ *
+ * The polygon's own edges are used (rather than those of the polygon
+ * clipped to the window, whose new vertices would be snapped
+ * differently), so the pixels don't change when it crosses the edge of
+ * the window. Only a polygon that is too large for the edge functions
+ * to be exact is clipped first.
+ *
+ * @param polygon    The vertices of the polygon
+ * @param color      The color to use
+ * @param technique  SCAN_LINE or POINTWISE
+ */
+template <int N>
+void
+Rasterizer2D::fillPolygon(const Matrix<2,N>& polygon, const Color& color,
+                          int technique)
+{
+    const double limit = EdgeFunctions<N>::MAX_COORDINATE;
+    Matrix<2,2> window = getWindow(), pixels;
+
+    if(contains(Matrix<2,2>(-limit, limit, -limit, limit), getBounds(polygon)))
     {
-        for(int x = bound(0,0); x <= bound(0,1); x++)
-        {
-            testPoint = {x,y};
-            
-            if((testHalfspace<2>(testPoint, implicit[0], bs[0]) == sign[0]) &&
-                    (testHalfspace<2>(testPoint, implicit[1], bs[1]) == sign[1]) &&
-                    (testHalfspace<2>(testPoint, implicit[2], bs[2]) == sign[2]) &&
-                    (testHalfspace<2>(testPoint, implicit[3], bs[3]) == sign[3]))
-            {   
-                fb->setPixel(x,y, color); 
-            }
-        }
+        if(!getPixels(getBounds(polygon), window, &pixels))
+            return;
 
+        if(technique == SCAN_LINE)
+            fillSpans<N>(polygon, pixels, color);
+        else
+            fillEdges<N>(polygon, pixels, color);
+    }
+    else
+    {
+        Matrix<2,N+4> clipped;
+        if(clipPolygon<N>(polygon, window, &clipped) < 3 ||
+           !getPixels(getBounds(clipped), window, &pixels))
+            return;
+
+        if(technique == SCAN_LINE)
+            fillSpans<N+4>(clipped, pixels, color);
+        else
+            fillEdges<N+4>(clipped, pixels, color);
     }
 }
 
+/**
+ * Fill a convex polygon by stepping its edge functions (see
+ * EdgeFunctions in Geometry.hpp) across a rectangle of pixels, a
+ * batch of pixels at a time, and drawing the runs of pixels that are
+ * inside it
+ *
+ * @param polygon  The vertices of the polygon
+ * @param pixels   The (visible part of the) bounding rectangle, in whole
+ *                 pixels, in the format returned by getBounds()
+ * @param color    The color to use
+ */
+template <int N>
 void
-Rasterizer2D::pointwiseFillTriangle(const Matrix<2,3>& triangle,
-                                    const Color& color)
+Rasterizer2D::fillEdges(const Matrix<2,N>& polygon, const Matrix<2,2>& pixels,
+                        const Color& color)
 {
-    Matrix<2,2> bound;
-    bound = getBounds(triangle);
-    Vector<2> testPoint;
-    int xstart,xend;
+    EdgeFunctions<N> edges(polygon);
+    if(edges.isEmpty())
+        return;
 
-    for(int y = bound(1,0); y <= bound(1,1); y++)
+    int xMin = (int)pixels.get<0,0>(), xMax = (int)pixels.get<0,1>();
+    int yMin = (int)pixels.get<1,0>(), yMax = (int)pixels.get<1,1>();
+    const int batch = EdgeFunctions<N>::BATCH;
+    long long row[N], e[N];
+
+    edges.evaluate(xMin, yMin, row);
+    for(int y = yMin; y <= yMax; ++y, edges.stepY(row))
     {
-        /*
-        for(int x = bound(0,0); x < bound(0,1); x++)
-        {
-            testPoint = {x,y};
-            if(inside<2>(testPoint, triangle.getColumn(0), triangle.getColumn(1), triangle.getColumn(2)))
-            {
-                xstart = x;
-                break;
-                //fb->setPixel(x,y, color);
-            }
-        }
+        for(int i = 0; i < N; ++i)
+            e[i] = row[i];
 
-        for (int x = bound(0,1); x > xstart; x--)
+        for(int x = xMin; x <= xMax; x += batch, edges.stepX(e, batch))
         {
-            testPoint = {x,y};
-            if(inside<2>(testPoint, triangle.getColumn(0), triangle.getColumn(1), triangle.getColumn(2)))
-            {
-                xend = x;
-                break;
-                //fb->setPixel(x,y, color);
-            }
-        }
+            unsigned int mask = edges.coverage(e);
 
-        for (int x = xstart; x < xend; x++)
-        {
-            fb->setPixel(x,y,color);
-        }
-        */
-        for(int x = bound(0,0); x <= bound(0,1); x++)
-        {
-            testPoint = {x,y};
-            if(inside<2>(testPoint, triangle.getColumn(0), triangle.getColumn(1), triangle.getColumn(2)))
+            //drop the pixels past the end of the bounding rectangle
+            if(xMax - x < batch - 1)
+                mask &= (1u << (xMax - x + 1)) - 1;
+
+            //draw each run of consecutive pixels that are inside
+            while(mask != 0)
             {
-                fb->setPixel(x,y, color);
+                int start  = countTrailingZeros(mask);
+                int length = countTrailingZeros(~(mask >> start));
+
+                fb->setPixels(x + start, y, length, color);
+                mask &= ~(((1u << length) - 1) << start);
             }
         }
     }
 }
 
+/**
+ * Fill a convex polygon a row at a time, using its edge table (see
+ * EdgeTable in Geometry.hpp) to find the ends of the span of pixels in
+ * each row (so that only the pixels that are inside it are visited)
+ *
+ * @param polygon  The vertices of the polygon
+ * @param pixels   The (visible part of the) bounding rectangle, in whole
+ *                 pixels, in the format returned by getBounds()
+ * @param color    The color to use
+ */
+template <int N>
+void
+Rasterizer2D::fillSpans(const Matrix<2,N>& polygon, const Matrix<2,2>& pixels,
+                        const Color& color)
+{
+    EdgeTable<N> table(polygon);
+    if(table.isEmpty())
+        return;
+
+    int xMin = (int)pixels.get<0,0>(), xMax = (int)pixels.get<0,1>();
+    int yMin = (int)pixels.get<1,0>(), yMax = (int)pixels.get<1,1>();
+    int left, right;
+
+    table.start(yMin);
+    for(int y = yMin; y <= yMax; ++y, table.step())
+    {
+        if(!table.getSpan(&left, &right))
+            continue;
+
+        //keep the span within the bounding rectangle
+        left  = std::max(left, xMin);
+        right = std::min(right, xMax);
+        if(left <= right)
+            fb->setPixels(left, y, right - left + 1, color);
+    }
+}
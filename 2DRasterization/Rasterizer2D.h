@@ -13,6 +13,7 @@
 #include "FrameBuffer.h"
 #include "Geometry.hpp"
 #include <cmath>
+#include <stdexcept>
 #include "../Matrix/Matrix.hpp"
 #include "../Matrix/Vector.hpp"
 
@@ -31,6 +32,9 @@ class Rasterizer2D
    static const int SCAN_LINE = 0;
    static const int POINTWISE = 1;
 
+   static const int PARAMETRIC  = 2;
+   static const int INCREMENTAL = 3;
+
   /**
    * Explicit Value Constructor
    *
@@ -45,7 +49,9 @@ class Rasterizer2D
    void clear(const Color& color);
 
   /**
-   * Draw a line using the (non-incremental) parametric approach
+   * Draw a line (using the line technique, i.e., the parametric
+   * approach unless the incremental approach was selected with
+   * setLineTechnique())
    *
    * @param p     One end point
    * @param q     The other end point
@@ -114,6 +120,7 @@ class Rasterizer2D
   /**
    * Fill a quadrilateral by testing all of the points
    * in its bounding rectangle using the halfspace test
+   * (i.e., the edge functions, which are stepped incrementally)
    *
    * @param quad    The vertices of the quadrilateral
    * @param color   The color to use
@@ -123,17 +130,86 @@ class Rasterizer2D
 
   /**
    * Fill a triangle point-by-point in the given color  using
-   * the signed-area algorithm
+   * the signed-area algorithm (i.e., the edge functions, which are
+   * stepped incrementally)
    *
    * @param triangle The vertices of the triangle
    * @param color The color to use
    */
    void pointwiseFillTriangle(const Matrix<2,3>& triangle, const Color& color);
+
+  /**
+   * Fill a quadrilateral a row at a time, using its edge table to
+   * find the span of pixels in each row
+   *
+   * @param quad    The vertices of the quadrilateral
+   * @param color   The color to use
+   */
+   void scanLineFillQuadrilateral(const Matrix<2,4>& quad,
+                                  const Color& color);
+
+  /**
+   * Fill a triangle a row at a time, using its edge table to find the
+   * span of pixels in each row
+   *
+   * @param triangle The vertices of the triangle
+   * @param color    The color to use
+   */
+   void scanLineFillTriangle(const Matrix<2,3>& triangle, const Color& color);
+
+  /**
+   * Set the algorithm used by fillQuadrilateral() and fillTriangle(),
+   * either SCAN_LINE (the default, which only visits the pixels that
+   * are inside) or POINTWISE (which tests every pixel of the bounding
+   * rectangle). They fill the same pixels.
+   *
+   * @param technique  SCAN_LINE or POINTWISE
+   * @throws           invalid_argument if technique is neither
+   */
+   void setFillTechnique(int technique);
+
+  /**
+   * Set the approach used by drawLine(), either PARAMETRIC (the
+   * default, which calculates each pixel from the line's equation in
+   * floating point) or INCREMENTAL (which steps from pixel to pixel with
+   * exact integer arithmetic, and is faster). They can draw a few
+   * different pixels: where the line passes halfway between two pixels
+   * (which the rounding error of PARAMETRIC can tip either way) and for
+   * end points that aren't at whole pixels (which INCREMENTAL snaps to
+   * 1/256 of a pixel).
+   *
+   * @param technique  PARAMETRIC or INCREMENTAL
+   * @throws           invalid_argument if technique is neither
+   */
+   void setLineTechnique(int technique);
    
 
   private:
    FrameBuffer*   fb;
    int            fillTechnique;
+   int            lineTechnique;
+
+   Matrix<2,2> getWindow() const;
+
+   void incrementalLine(const Matrix<2,1>& p, const Matrix<2,1>& q,
+                        const Matrix<2,1>& cp, const Matrix<2,1>& cq,
+                        const Color& color);
+
+   void parametricLine(const Matrix<2,1>& p, const Matrix<2,1>& q,
+                       const Matrix<2,1>& cp, const Matrix<2,1>& cq,
+                       const Color& color);
+
+   template <int N>
+   void fillPolygon(const Matrix<2,N>& polygon, const Color& color,
+                    int technique);
+
+   template <int N>
+   void fillEdges(const Matrix<2,N>& polygon, const Matrix<2,2>& pixels,
+                  const Color& color);
+
+   template <int N>
+   void fillSpans(const Matrix<2,N>& polygon, const Matrix<2,2>& pixels,
+                  const Color& color);
    
    
 };
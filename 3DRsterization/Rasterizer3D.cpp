@@ -11,13 +11,13 @@
 
 #define PI 3.14159265358979323846
 
+// The projection onto the x-y plane (which is built at compile time)
+static constexpr Matrix<2,4> XY_PROJECTION({1,0,0,0,
+                                            0,1,0,0});
+
 Rasterizer3D::Rasterizer3D(FrameBuffer * fb)
 {
-    this->view = {1,0,0,0,
-                  0,1,0,0,
-                  0,0,1,0,
-                  0,0,0,1};
-
+    // The TransformStack starts out as the identity
     this->rast = new Rasterizer2D(fb);
 }
 
@@ -32,47 +32,27 @@ Rasterizer3D::clear(const Color& color)
     this->rast->clear(color);
 }
 
-/**
- * apply transformation to a given vector
- *
- * @param v vector
- * @param tran transform matrix 
- *
- * @return transformed vector 
- */
-Matrix<4,1>
-Rasterizer3D::applyTransform(const Matrix<4,1>& v, const Matrix<4,4>& tran)
-{
-    Matrix<4,1> ret;
-    ret = tran * v;
-    return ret;
-}
-
 void
 Rasterizer3D::draw(list<Triangle*> triangles)
 {
     //iterate list
     std::list<Triangle*>::iterator it;
+    int t;
 
-    Matrix<4,3> trans, applyMatrix;
-    Matrix<4,1> a,b,c;
+    //gather the vertices of all of the triangles, so that they can be
+    //transformed with one product
+    DynamicMatrix<> vertices(4, 3 * (int)triangles.size());
+    for(t = 0, it = triangles.begin(); it != triangles.end(); ++it, ++t)
+        vertices.setBlock(0, 3 * t, (*it)->vertices);
 
-    Matrix<2,4> pre;
-    pre = {1,0,0,0,
-           0,1,0,0};
+    //apply the transform and take off x,y (in one 2x4 Matrix)
+    Matrix<2,4> toScreen  = XY_PROJECTION * this->view.getProduct();
+    DynamicMatrix<> projected = toScreen * vertices;
 
     Color WHITE = {255,255,255};
-    for(it = triangles.begin(); it != triangles.end(); ++it)
+    for(t = 0, it = triangles.begin(); it != triangles.end(); ++it, ++t)
     {
-        //apply transform to each vertex
-        a = applyTransform((*it)->vertices.getColumn(0), this->view);
-        b = applyTransform((*it)->vertices.getColumn(1), this->view);
-        c = applyTransform((*it)->vertices.getColumn(2), this->view);
-        //conat vetices back 
-        applyMatrix = a|b|c; 
-       
-        //take off x,y from transformed triangle
-        Matrix<2,3> tri = pre * applyMatrix;
+        Matrix<2,3> tri = projected.getBlock<2,3>(0, 3 * t);
 
         //draw it on 2d
         this->rast->drawTriangle(tri, (*it)->frontColor);
@@ -89,19 +69,37 @@ Rasterizer3D::draw(list<Triangle*> triangles)
 void
 Rasterizer3D::setProjections(double phi, double theta)
 {
-    Matrix<4,4> rx, ry;
-    
-    rx = {1,        0,         0, 0,
-          0, cos(phi), -sin(phi), 0,
-          0, sin(phi),  cos(phi), 0,
-          0,        0,         0, 1};
-
-    ry = {cos(theta),0,sin(theta),0,
-                   0,1,         0,0,
-         -sin(theta),0,cos(theta),0,
-                   0,0,         0,1};
-    
-    this->view = rx * ry;  
+    this->setView(identity<4>(), AffineTransform<>(), phi, theta);
+}
+
+/**
+ * set the factors of the view (only the factors that differ from the
+ * current ones are recomposed, e.g., when only theta changes)
+ *
+ * @param projection the projection (the identity for parallel views)
+ * @param translation the translation
+ * @param phi rotation around the x-axis in radians
+ * @param theta rotation around the y-axis in radians
+ */
+void
+Rasterizer3D::setView(const Matrix<4,4>& projection,
+                      const AffineTransform<>& translation,
+                      double phi, double theta)
+{
+    this->orbit = Quaternion<>();
+
+    this->view.set(PROJECTION, projection);
+    this->view.set(TRANSLATION, translation);
+    this->view.set(ORBIT, this->orbit.toMatrix());
+    this->view.set(PITCH, AffineTransform<>::rotationX(phi));
+    this->view.set(YAW, AffineTransform<>::rotationY(theta));
+}
+
+void
+Rasterizer3D::rotateView(const Quaternion<>& rotation)
+{
+    this->orbit = normalized(rotation * this->orbit);
+    this->view.set(ORBIT, this->orbit.toMatrix());
 }
 
 void
@@ -131,29 +129,13 @@ Rasterizer3D::useThreePointPerspectiveView(double d,
 	double phi, double theta)
 {
     this->viewOption = THREE_PERSPECTIVE;
-    Matrix<4,4> p, rx, ry, t;
-    
-    p = {1,0,  0,0,
-         0,1,  0,0,
-         0,0,  0,0,
-         0,0,1/d,1};
-    
-    rx = {1,        0,         0, 0,
-          0, cos(phi), -sin(phi), 0,
-          0, sin(phi),  cos(phi), 0,
-          0,        0,         0, 1};
-
-    ry = {cos(theta),0,sin(theta),0,
-                   0,1,         0,0,
-         -sin(theta),0,cos(theta),0,
-                   0,0,         0,1};
-    
-    t = {1,0,0,tx,
-         0,1,0,ty,
-         0,0,1,tz,
-         0,0,0, 1};
-
-    this->view = p * t * rx * ry;
+    Matrix<4,4> projection(1,0,  0,0,
+                           0,1,  0,0,
+                           0,0,  0,0,
+                           0,0,1/d,1);
+
+    this->setView(projection, AffineTransform<>::translation(tx, ty, tz),
+                  phi, theta);
 }
 
 void
@@ -171,9 +153,14 @@ Rasterizer3D::useTwoPointPerspectiveView(double d,
 	double ty, double tz,
 	double theta)
 {
+   // This is the three-point perspective view with no translation
+   // along, and no rotation around, the x-axis
    this->viewOption = TWO_PERSPECTIVE;
-   this->view = {cos(theta), 0,     sin(theta),        0,
-                          0, 1,              0,       ty,
-                          0, 0,              0,        0,
-              -sin(theta)/d, 0,   cos(theta)/d, tz/d + 1 };
+   Matrix<4,4> projection(1,0,  0,0,
+                          0,1,  0,0,
+                          0,0,  0,0,
+                          0,0,1/d,1);
+
+   this->setView(projection, AffineTransform<>::translation(0, ty, tz),
+                 0, theta);
 }
@@ -13,6 +13,10 @@
 #include "../2DRasterization/Geometry.hpp"
 #include <list>
 #include "../Matrix/Matrix.hpp"
+#include "../Matrix/AffineTransform.hpp"
+#include "../Matrix/Quaternion.hpp"
+#include "../Matrix/DynamicMatrix.hpp"
+#include "../Matrix/TransformStack.hpp"
 #include "../2DRasterization/Rasterizer2D.h"
 #include "Triangle.h"
 #define TOLERANCE  0.0001
@@ -30,7 +34,19 @@ class Rasterizer3D
     Rasterizer2D * rast;
     double theta, phi;
 
-    Matrix<4,4> view;
+    // The view is the product of its factors (outermost first): the
+    // projection (the identity for the parallel views), the
+    // translation, the orbit (see rotateView()), and the rotations
+    // around the x-axis (phi) and the y-axis (theta). The stack keeps
+    // the partial products, so changing theta only costs one product.
+    static const int PROJECTION = 0;
+    static const int TRANSLATION = 1;
+    static const int ORBIT = 2;
+    static const int PITCH = 3;
+    static const int YAW = 4;
+
+    TransformStack<5> view;
+    Quaternion<>      orbit;
 
     int viewOption;
 
@@ -41,9 +57,9 @@ class Rasterizer3D
     static const int ISOVIEW = 0;
     
     void setProjections(double phi, double theta);
-
-    Matrix<4,1> applyTransform(const Matrix<4,1>& v, 
-                               const Matrix<4,4>& tran);
+    void setView(const Matrix<4,4>& projection,
+                 const AffineTransform<>& translation,
+                 double phi, double theta);
     
  public:
     /**
@@ -129,6 +145,16 @@ class Rasterizer3D
     void useTwoPointPerspectiveView(double d, 
                                     double ty, double tz,
                                     double theta);
+
+    /**
+     * Rotates the current view (e.g., for an orbit camera). The rotation
+     * is applied after the current orientation (and before the
+     * translation and projection), so this costs a quaternion product
+     * and only recomposes the rotation part of the view.
+     *
+     * @param rotation   The rotation (a unit Quaternion)
+     */
+    void rotateView(const Quaternion<>& rotation);
     
     
     
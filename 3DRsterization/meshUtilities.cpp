@@ -155,26 +155,21 @@ void scaleAndTranslate(list<Triangle*> triangles,
    if(longest < z)
        cscale = depth/z;
 
-   Matrix<4,4> scale, translate, m;
-   // Setup the scaling matrix
-   scale = {cscale,     0,    0,0,
-                0, cscale,    0,0,
-                0,     0, cscale,0,
-                0,     0,    0,1};
+   // Setup the scaling transformation
+   AffineTransform<> scale = AffineTransform<>::scaling(cscale);
    // Setup the translation matrix to center the object
    // find center of mass
    double xsum, ysum, zsum;
    xsum = (bound(0,1) + bound(0,0)) * 4;
    ysum = (bound(1,1) + bound(1,0)) * 4;
    zsum = (bound(2,1) + bound(2,0)) * 4;
-   translate = {1, 0, 0, -xsum/8.0,
-                0, 1, 0, -ysum/8.0,
-                0, 0, 1, -zsum/8.0,
-                0, 0, 0, 1};
-   // Setup the transformation matrix
+   AffineTransform<> translate = AffineTransform<>::translation(-xsum/8.0,
+                                                                -ysum/8.0,
+                                                                -zsum/8.0);
+   // Setup the transformation
    //   Translate first (since the translation was calculated in the
    //   original units) and then scale
-   m = scale * translate;
+   AffineTransform<> m = scale * translate;
    std::list<Triangle*>::iterator it;
 
    // Transform
@@ -14,6 +14,7 @@
 #include "../2DRasterization/Geometry.hpp"
 #include <list>
 #include "../Matrix/Matrix.hpp"
+#include "../Matrix/AffineTransform.hpp"
 #include <stdio.h>
 #include "Triangle.h"
 
@@ -0,0 +1,519 @@
+/**
+ * AffineTransform template
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __cs_affine_transform_hpp__
+#define __cs_affine_transform_hpp__
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "Matrix.hpp"
+
+/**
+ * An affine transformation (e.g., a rotation, scaling, or translation)
+ * in homogeneous coordinates. As a 4x4 Matrix an affine transformation
+ * always has 0 0 0 1 as its last row, so only the other three rows are
+ * stored (i.e., a 3x3 linear part, L, and a translation, t) and the
+ * operations skip the multiplications by the constant row.
+ *
+ * Example of use:
+ *
+ *   AffineTransform<> view = AffineTransform<>::rotationX(phi)
+ *                          * AffineTransform<>::rotationY(theta);
+ *   Matrix<4,3>       v    = view * triangle.vertices;
+ *
+ * Note: Perspective projections aren't affine, so they must be kept in
+ * a Matrix<4,4> (which can be multiplied by an AffineTransform).
+ */
+template <class T = double>
+class AffineTransform
+{
+  private:
+    Matrix<3,4,T>  m;
+
+  public:
+    typedef T Scalar;
+
+    /**
+     * Construct the identity transformation
+     */
+    constexpr AffineTransform();
+
+    /**
+     * Construct a transformation from the first three rows of its 4x4
+     * Matrix (i.e., [L | t])
+     *
+     * @param m   The 3x4 Matrix
+     */
+    constexpr explicit AffineTransform(const Matrix<3,4,T>& m);
+
+    /**
+     * Construct a transformation from its 4x4 Matrix
+     *
+     * @param a   The 4x4 Matrix
+     * @throws    invalid_argument if the last row of a isn't 0 0 0 1
+     */
+    constexpr explicit AffineTransform(const Matrix<4,4,T>& a);
+
+    /**
+     * Create a rotation around the x-axis
+     *
+     * @param angle   The angle (in radians)
+     * @return        The rotation
+     */
+    static AffineTransform rotationX(T angle);
+
+    /**
+     * Create a rotation around the y-axis
+     *
+     * @param angle   The angle (in radians)
+     * @return        The rotation
+     */
+    static AffineTransform rotationY(T angle);
+
+    /**
+     * Create a rotation around the z-axis
+     *
+     * @param angle   The angle (in radians)
+     * @return        The rotation
+     */
+    static AffineTransform rotationZ(T angle);
+
+    /**
+     * Create a (uniform) scaling
+     *
+     * @param s   The scale factor
+     * @return    The scaling
+     */
+    static constexpr AffineTransform scaling(T s);
+
+    /**
+     * Create a translation
+     *
+     * @param tx  The translation along the x-axis
+     * @param ty  The translation along the y-axis
+     * @param tz  The translation along the z-axis
+     * @return    The translation
+     */
+    static constexpr AffineTransform translation(T tx, T ty, T tz);
+
+    /**
+     * Get a particular element of the 4x4 Matrix of this transformation
+     *
+     * @param r   The row index
+     * @param c   The column index
+     * @throws    out_of_range if r or c are out of bounds
+     * @return    The value of the element
+     */
+    constexpr T get(int r, int c) const;
+
+    /**
+     * Get the 4x4 Matrix of this transformation
+     *
+     * @return    The Matrix (with 0 0 0 1 as its last row)
+     */
+    constexpr Matrix<4,4,T> toMatrix() const;
+
+    /**
+     * Calculate the inverse of this transformation, assuming that it is
+     * a rigid-body transformation (i.e., that L is a rotation). Then the
+     * inverse is [L^T | -L^T t], which doesn't require any division.
+     *
+     * @return    The inverse
+     */
+    constexpr AffineTransform rigidInverse() const;
+
+    /**
+     * Calculate the inverse of this transformation (i.e.,
+     * [L^-1 | -L^-1 t])
+     *
+     * @throws    domain_error if L is singular
+     * @return    The inverse
+     */
+    AffineTransform inverse() const;
+
+    /**
+     * Compose two transformations (i.e., a * b applies b and then a)
+     */
+    template <class U>
+    friend constexpr AffineTransform<U> operator*(const AffineTransform<U>& a,
+                                                  const AffineTransform<U>& b);
+
+    /**
+     * Apply a transformation to C points (i.e., the columns of p)
+     */
+    template <int C, class U>
+    friend constexpr Matrix<4,C,U> operator*(const AffineTransform<U>& a,
+                                             const Matrix<4,C,U>& p);
+
+    /**
+     * Compose a (e.g., perspective) 4x4 Matrix with a transformation
+     */
+    template <class U>
+    friend constexpr Matrix<4,4,U> operator*(const Matrix<4,4,U>& a,
+                                             const AffineTransform<U>& b);
+
+    template <class U>
+    friend constexpr bool operator==(const AffineTransform<U>& a,
+                                     const AffineTransform<U>& b);
+};
+
+
+
+// Templates
+
+/**
+ * Construct the identity transformation
+ */
+template <class T>
+constexpr AffineTransform<T>::AffineTransform()
+    : m({1,0,0,0,
+         0,1,0,0,
+         0,0,1,0})
+{
+}
+
+
+/**
+ * Construct a transformation from the first three rows of its 4x4
+ * Matrix (i.e., [L | t])
+ *
+ * @param m   The 3x4 Matrix
+ */
+template <class T>
+constexpr AffineTransform<T>::AffineTransform(const Matrix<3,4,T>& m)
+    : m(m)
+{
+}
+
+
+/**
+ * Construct a transformation from its 4x4 Matrix
+ *
+ * @param a   The 4x4 Matrix
+ * @throws    invalid_argument if the last row of a isn't 0 0 0 1
+ */
+template <class T>
+constexpr AffineTransform<T>::AffineTransform(const Matrix<4,4,T>& a)
+{
+    if(a.get(3,0) != T(0) || a.get(3,1) != T(0) || a.get(3,2) != T(0) ||
+       a.get(3,3) != T(1))
+        throw std::invalid_argument("AffineTransform: not an affine transformation");
+
+    for(int r = 0; r < 3; ++r)
+        for(int c = 0; c < 4; ++c)
+            m(r,c) = a.get(r,c);
+}
+
+
+/**
+ * Create a rotation around the x-axis
+ *
+ * @param angle   The angle (in radians)
+ * @return        The rotation
+ */
+template <class T>
+AffineTransform<T> AffineTransform<T>::rotationX(T angle)
+{
+    T s = sin(angle), c = cos(angle);
+
+    return AffineTransform(Matrix<3,4,T>({1, 0,  0, 0,
+                                          0, c, -s, 0,
+                                          0, s,  c, 0}));
+}
+
+
+/**
+ * Create a rotation around the y-axis
+ *
+ * @param angle   The angle (in radians)
+ * @return        The rotation
+ */
+template <class T>
+AffineTransform<T> AffineTransform<T>::rotationY(T angle)
+{
+    T s = sin(angle), c = cos(angle);
+
+    return AffineTransform(Matrix<3,4,T>({ c, 0, s, 0,
+                                           0, 1, 0, 0,
+                                          -s, 0, c, 0}));
+}
+
+
+/**
+ * Create a rotation around the z-axis
+ *
+ * @param angle   The angle (in radians)
+ * @return        The rotation
+ */
+template <class T>
+AffineTransform<T> AffineTransform<T>::rotationZ(T angle)
+{
+    T s = sin(angle), c = cos(angle);
+
+    return AffineTransform(Matrix<3,4,T>({c, -s, 0, 0,
+                                          s,  c, 0, 0,
+                                          0,  0, 1, 0}));
+}
+
+
+/**
+ * Create a (uniform) scaling
+ *
+ * @param s   The scale factor
+ * @return    The scaling
+ */
+template <class T>
+constexpr AffineTransform<T> AffineTransform<T>::scaling(T s)
+{
+    return AffineTransform(Matrix<3,4,T>({s, 0, 0, 0,
+                                          0, s, 0, 0,
+                                          0, 0, s, 0}));
+}
+
+
+/**
+ * Create a translation
+ *
+ * @param tx  The translation along the x-axis
+ * @param ty  The translation along the y-axis
+ * @param tz  The translation along the z-axis
+ * @return    The translation
+ */
+template <class T>
+constexpr AffineTransform<T> AffineTransform<T>::translation(T tx, T ty, T tz)
+{
+    return AffineTransform(Matrix<3,4,T>({1, 0, 0, tx,
+                                          0, 1, 0, ty,
+                                          0, 0, 1, tz}));
+}
+
+
+/**
+ * Get a particular element of the 4x4 Matrix of this transformation
+ *
+ * @param r   The row index
+ * @param c   The column index
+ * @throws    out_of_range if r or c are out of bounds
+ * @return    The value of the element
+ */
+template <class T>
+constexpr T AffineTransform<T>::get(int r, int c) const
+{
+    if(r == 3)
+    {
+        if(0 > c || c > 3)
+            throw std::out_of_range("get(int,int): out of range");
+        return c == 3 ? T(1) : T(0);
+    }
+    return m.get(r, c);
+}
+
+
+/**
+ * Get the 4x4 Matrix of this transformation
+ *
+ * @return    The Matrix (with 0 0 0 1 as its last row)
+ */
+template <class T>
+constexpr Matrix<4,4,T> AffineTransform<T>::toMatrix() const
+{
+    Matrix<4,4,T> result;
+
+    for(int r = 0; r < 3; ++r)
+        for(int c = 0; c < 4; ++c)
+            result(r,c) = m.get(r,c);
+    result(3,3) = T(1);
+
+    return result;
+}
+
+
+/**
+ * Calculate the inverse of this transformation, assuming that it is
+ * a rigid-body transformation (i.e., that L is a rotation). Then the
+ * inverse is [L^T | -L^T t], which doesn't require any division.
+ *
+ * @return    The inverse
+ */
+template <class T>
+constexpr AffineTransform<T> AffineTransform<T>::rigidInverse() const
+{
+    AffineTransform result;
+
+    for(int r = 0; r < 3; ++r)
+    {
+        T t = T(0);
+        for(int c = 0; c < 3; ++c)
+        {
+            result.m(r,c) = m.get(c,r);
+            t -= m.get(c,r) * m.get(c,3);
+        }
+        result.m(r,3) = t;
+    }
+
+    return result;
+}
+
+
+/**
+ * Calculate the inverse of this transformation (i.e.,
+ * [L^-1 | -L^-1 t]), where L^-1 is the adjugate of L divided by
+ * its determinant
+ *
+ * L is treated as singular if its determinant is (relative to the
+ * product of the lengths of its rows, which bounds the determinant)
+ * smaller than the rounding error, so the scale of the transformation
+ * doesn't matter.
+ *
+ * @throws    domain_error if L is singular
+ * @return    The inverse
+ */
+template <class T>
+AffineTransform<T> AffineTransform<T>::inverse() const
+{
+    Matrix<3,3,T> l = m.template blockView<3,3>(0,0);
+    T             d = det(l);
+    T             bound = T(1);
+
+    for(int r = 0; r < 3; ++r)
+        bound *= sqrt(l(r,0) * l(r,0) + l(r,1) * l(r,1) + l(r,2) * l(r,2));
+
+    if(abs(d) <= 4 * std::numeric_limits<T>::epsilon() * bound)
+        throw std::domain_error("inverse: singular matrix");
+
+    AffineTransform result;
+    for(int r = 0; r < 3; ++r)
+    {
+        // The cofactors of the transpose (with cyclic indexes, so that
+        // the signs are built in)
+        int r1 = (r + 1) % 3, r2 = (r + 2) % 3;
+        for(int c = 0; c < 3; ++c)
+        {
+            int c1 = (c + 1) % 3, c2 = (c + 2) % 3;
+            result.m(r,c) = (l(c1,r1) * l(c2,r2) - l(c1,r2) * l(c2,r1)) / d;
+        }
+    }
+    for(int r = 0; r < 3; ++r)
+    {
+        T t = T(0);
+        for(int k = 0; k < 3; ++k)
+            t -= result.m(r,k) * m.get(k,3);
+        result.m(r,3) = t;
+    }
+
+    return result;
+}
+
+
+/**
+ * Compose two transformations (i.e., a * b applies b and then a).
+ * This takes 36 multiplications (rather than 64 for the 4x4 Matrix
+ * objects).
+ *
+ * @param a   The transformation to apply second
+ * @param b   The transformation to apply first
+ * @return    The composition
+ */
+template <class T>
+constexpr AffineTransform<T> operator*(const AffineTransform<T>& a,
+                                       const AffineTransform<T>& b)
+{
+    AffineTransform<T> result;
+
+    for(int r = 0; r < 3; ++r)
+    {
+        const T* x = a.m.rowPointer(r);
+        for(int c = 0; c < 4; ++c)
+        {
+            T sum = x[0] * b.m.get(0,c) + x[1] * b.m.get(1,c) + x[2] * b.m.get(2,c);
+            if(c == 3) sum += x[3];
+            result.m(r,c) = sum;
+        }
+    }
+
+    return result;
+}
+
+
+/**
+ * Apply a transformation to C points (i.e., the columns of p). The last
+ * row of the result is the last row of p, so this takes 12C
+ * multiplications (rather than 16C for the 4x4 Matrix).
+ *
+ * @param a   The transformation
+ * @param p   The 4xC Matrix of points (in homogeneous coordinates)
+ * @return    The 4xC Matrix of transformed points
+ */
+template <int C, class T>
+constexpr Matrix<4,C,T> operator*(const AffineTransform<T>& a,
+                                  const Matrix<4,C,T>& p)
+{
+    Matrix<4,C,T> result;
+    const T* p0 = p.rowPointer(0);
+    const T* p1 = p.rowPointer(1);
+    const T* p2 = p.rowPointer(2);
+    const T* p3 = p.rowPointer(3);
+
+    for(int r = 0; r < 3; ++r)
+    {
+        const T* x = a.m.rowPointer(r);
+        T*       y = result.rowPointer(r);
+        for(int c = 0; c < C; ++c)
+            y[c] = x[0] * p0[c] + x[1] * p1[c] + x[2] * p2[c] + x[3] * p3[c];
+    }
+    T* w = result.rowPointer(3);
+    for(int c = 0; c < C; ++c)
+        w[c] = p3[c];
+
+    return result;
+}
+
+
+/**
+ * Compose a (e.g., perspective) 4x4 Matrix with a transformation
+ * (i.e., a * b applies b and then a). This takes 48 multiplications
+ * (rather than 64).
+ *
+ * @param a   The 4x4 Matrix
+ * @param b   The transformation
+ * @return    The 4x4 Matrix of the composition
+ */
+template <class T>
+constexpr Matrix<4,4,T> operator*(const Matrix<4,4,T>& a,
+                                  const AffineTransform<T>& b)
+{
+    Matrix<4,4,T> result;
+
+    for(int r = 0; r < 4; ++r)
+    {
+        const T* x = a.rowPointer(r);
+        T*       y = result.rowPointer(r);
+        for(int c = 0; c < 4; ++c)
+            y[c] = x[0] * b.m.get(0,c) + x[1] * b.m.get(1,c) + x[2] * b.m.get(2,c);
+        y[3] += x[3];
+    }
+
+    return result;
+}
+
+
+/**
+ * Determine whether two transformations are equal (within TOLERANCE)
+ *
+ * @param a   One transformation
+ * @param b   The other transformation
+ * @return    true if they are equal; false otherwise
+ */
+template <class T>
+constexpr bool operator==(const AffineTransform<T>& a,
+                          const AffineTransform<T>& b)
+{
+    return a.m == b.m;
+}
+
+#endif
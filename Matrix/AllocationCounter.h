@@ -0,0 +1,144 @@
+/**
+ * Allocation counter for benchmarks
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __cs_allocation_counter_h__
+#define __cs_allocation_counter_h__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Replaces the global operator new and operator delete (all of the
+ * replaceable forms that allocate or free, including the sized and
+ * aligned ones) so that every heap allocation is counted.
+ *
+ * The counters are atomic so that allocations made by other threads
+ * (e.g., those of a ThreadPool) are counted correctly.
+ *
+ * Note: The replacements are (and must be) ordinary definitions, so
+ * this header must be included by exactly one source file of a program
+ * (i.e., the benchmark itself).
+ */
+struct AllocationCounter
+{
+   static inline std::atomic<std::size_t> allocations{0};
+   static inline std::atomic<std::size_t> bytes{0};
+
+   /**
+    * Reset both counters to 0
+    */
+   static void reset()
+   {
+      allocations = 0;
+      bytes       = 0;
+   }
+
+   /**
+    * Count and make an allocation
+    *
+    * @param size       The size (in bytes)
+    * @param alignment  The alignment (0 for the default)
+    * @return           The memory (which must be freed with release())
+    * @throws           std::bad_alloc if it can't be allocated
+    */
+   static void* acquire(std::size_t size, std::size_t alignment)
+   {
+      allocations.fetch_add(1, std::memory_order_relaxed);
+      bytes.fetch_add(size, std::memory_order_relaxed);
+
+      if (size == 0) size = 1;
+
+      void* p;
+      if (alignment <= alignof(std::max_align_t))
+         p = std::malloc(size);
+      else
+         // aligned_alloc() requires the size to be a multiple of the alignment
+         p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+
+      if (p == NULL) throw std::bad_alloc();
+      return p;
+   }
+
+   /**
+    * Free memory made by acquire()
+    *
+    * Note: This isn't inlined so that GCC can't see the call to free()
+    * in operator delete, where it would warn (wrongly) that the memory
+    * came from operator new (-Wmismatched-new-delete)
+    *
+    * @param p  The memory (or NULL)
+    */
+   [[gnu::noinline]] static void release(void* p) noexcept
+   {
+      std::free(p);
+   }
+};
+
+
+void* operator new(std::size_t size)
+{
+   return AllocationCounter::acquire(size, 0);
+}
+
+void* operator new[](std::size_t size)
+{
+   return AllocationCounter::acquire(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+   return AllocationCounter::acquire(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+   return AllocationCounter::acquire(size, (std::size_t)alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+   AllocationCounter::release(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+   AllocationCounter::release(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+   AllocationCounter::release(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+   AllocationCounter::release(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+   AllocationCounter::release(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+   AllocationCounter::release(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+   AllocationCounter::release(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+   AllocationCounter::release(p);
+}
+
+#endif
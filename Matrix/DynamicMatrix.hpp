@@ -0,0 +1,607 @@
+/**
+ * DynamicMatrix template
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __cs_dynamic_matrix_hpp__
+#define __cs_dynamic_matrix_hpp__
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "Matrix.hpp"
+
+// Products with at least this many multiply-adds are split across
+// several threads (by blocks of columns of the result)
+#ifndef DYNAMIC_MATRIX_PARALLEL_WORK
+#define DYNAMIC_MATRIX_PARALLEL_WORK   (1L << 22)
+#endif
+
+template <class T> class DynamicMatrix;
+
+template <class T>
+void multiply(const DynamicMatrix<T>& a, const DynamicMatrix<T>& b, DynamicMatrix<T>& result);
+
+/**
+ * A matrix whose size is chosen at run time (e.g., a 4 x 3N Matrix that
+ * contains all of the vertices of a mesh). The elements are stored in
+ * one contiguous, row-major, MATRIX_ALIGNMENT-aligned array.
+ *
+ * The product of two of them (see multiply()) is computed in cache-sized
+ * blocks with SIMD kernels and, for large products, on several threads.
+ * Since every element of the result is computed by one thread in a
+ * fixed order, the result doesn't depend on the number of threads.
+ *
+ * Example of use:
+ *
+ *   DynamicMatrix<> vertices(4, 3*n);
+ *   for(int t = 0; t < n; ++t) vertices.setBlock(0, 3*t, triangle[t]);
+ *
+ *   DynamicMatrix<> transformed = view * vertices;   // view is a Matrix<4,4>
+ */
+template <class T = double>
+class DynamicMatrix
+{
+  private:
+    T*   values;
+    int  rows, columns;
+
+    void allocate(int rows, int columns);
+    void deallocate();
+
+  public:
+    typedef T Scalar;
+
+    /**
+     * Construct a rows x columns DynamicMatrix (of 0s)
+     *
+     * @param rows      The number of rows
+     * @param columns   The number of columns
+     * @throws          invalid_argument if rows or columns is negative
+     */
+    DynamicMatrix(int rows = 0, int columns = 0);
+
+    /**
+     * Construct a DynamicMatrix from a Matrix
+     *
+     * @param m   The Matrix
+     */
+    template <int R, int C>
+    explicit DynamicMatrix(const Matrix<R,C,T>& m);
+
+    DynamicMatrix(const DynamicMatrix& original);
+    DynamicMatrix(DynamicMatrix&& original) noexcept;
+    ~DynamicMatrix();
+
+    /**
+     * Assign another DynamicMatrix (of any size) to this one
+     */
+    DynamicMatrix& operator=(const DynamicMatrix& other);
+    DynamicMatrix& operator=(DynamicMatrix&& other) noexcept;
+
+    /**
+     * Get the number of rows
+     */
+    int getRows() const;
+
+    /**
+     * Get the number of columns
+     */
+    int getColumns() const;
+
+    /**
+     * Get a particular element of this DynamicMatrix
+     *
+     * @param r   The row index
+     * @param c   The column index
+     * @throws    out_of_range if r or c are out of bounds
+     * @return    The value of the element
+     */
+    T get(int r, int c) const;
+
+    /**
+     * Access a particular element of this DynamicMatrix
+     *
+     * @param r   The row index
+     * @param c   The column index
+     * @throws    out_of_range if r or c are out of bounds
+     * @return    The element
+     */
+    T& operator()(int r, int c);
+
+    /**
+     * Get a pointer to the (contiguous, row-major) elements
+     */
+    const T* data() const;
+    T*       data();
+
+    /**
+     * Get an R x C block of this DynamicMatrix as a Matrix
+     *
+     * @param r   The row of the upper-left element of the block
+     * @param c   The column of the upper-left element of the block
+     * @throws    out_of_range if the block isn't inside this DynamicMatrix
+     * @return    The block
+     */
+    template <int R, int C>
+    Matrix<R,C,T> getBlock(int r, int c) const;
+
+    /**
+     * Copy a Matrix to an R x C block of this DynamicMatrix
+     *
+     * @param r   The row of the upper-left element of the block
+     * @param c   The column of the upper-left element of the block
+     * @param m   The Matrix
+     * @throws    out_of_range if the block isn't inside this DynamicMatrix
+     */
+    template <int R, int C>
+    void setBlock(int r, int c, const Matrix<R,C,T>& m);
+
+    /**
+     * Multiply two DynamicMatrix objects (into an existing result, so
+     * that repeated products don't allocate)
+     */
+    template <class U>
+    friend void multiply(const DynamicMatrix<U>& a, const DynamicMatrix<U>& b,
+                         DynamicMatrix<U>& result);
+};
+
+
+
+// Kernels
+
+/**
+ * The blocked product of a rows x depth block of A and a depth x columns
+ * block of B, which is added to the rows x columns block of C (all of
+ * which are row-major with the given strides)
+ *
+ * The generic version is a loop in i-p-j order (so that the innermost
+ * loop is over contiguous elements of B and C, which never overlap and
+ * so can be vectorized by the compiler).
+ */
+template <class T>
+struct DynamicMatrixKernel
+{
+    static void multiplyAdd(const T* A, int lda, const T* B, int ldb, T* C, int ldc,
+                            int rows, int depth, int columns)
+    {
+        for(int i = 0; i < rows; ++i)
+        {
+            T* __restrict c = C + i*ldc;
+            for(int p = 0; p < depth; ++p)
+            {
+                const T             a = A[i*lda + p];
+                const T* __restrict b = B + p*ldb;
+                for(int j = 0; j < columns; ++j)
+                    c[j] += a * b[j];
+            }
+        }
+    }
+};
+
+#if defined(MATRIX_SIMD_AVX)
+
+/**
+ * The blocked product for double elements, which computes MR x 8 blocks
+ * of C in registers (MR rows and two AVX registers per row)
+ */
+template <>
+struct DynamicMatrixKernel<double>
+{
+    template <int MR>
+    static void micro(const double* A, int lda, const double* B, int ldb,
+                      double* C, int ldc, int depth)
+    {
+        __m256d acc[MR][2];
+
+        for(int r = 0; r < MR; ++r)
+        {
+            acc[r][0] = _mm256_loadu_pd(C + r*ldc);
+            acc[r][1] = _mm256_loadu_pd(C + r*ldc + 4);
+        }
+        for(int p = 0; p < depth; ++p)
+        {
+            __m256d b0 = _mm256_loadu_pd(B + p*ldb);
+            __m256d b1 = _mm256_loadu_pd(B + p*ldb + 4);
+            for(int r = 0; r < MR; ++r)
+            {
+                __m256d a = _mm256_set1_pd(A[r*lda + p]);
+                acc[r][0] = matrix_madd(a, b0, acc[r][0]);
+                acc[r][1] = matrix_madd(a, b1, acc[r][1]);
+            }
+        }
+        for(int r = 0; r < MR; ++r)
+        {
+            _mm256_storeu_pd(C + r*ldc, acc[r][0]);
+            _mm256_storeu_pd(C + r*ldc + 4, acc[r][1]);
+        }
+    }
+
+    static void multiplyAdd(const double* A, int lda, const double* B, int ldb,
+                            double* C, int ldc, int rows, int depth, int columns)
+    {
+        const int full = columns - columns % 8;
+
+        for(int i = 0; i < rows; i += 4)
+        {
+            const int mr = std::min(4, rows - i);
+            for(int j = 0; j < full; j += 8)
+            {
+                const double* a = A + i*lda;
+                double*       c = C + i*ldc + j;
+                switch(mr)
+                {
+                    case 4: micro<4>(a, lda, B + j, ldb, c, ldc, depth); break;
+                    case 3: micro<3>(a, lda, B + j, ldb, c, ldc, depth); break;
+                    case 2: micro<2>(a, lda, B + j, ldb, c, ldc, depth); break;
+                    default: micro<1>(a, lda, B + j, ldb, c, ldc, depth); break;
+                }
+            }
+        }
+
+        // The last (partial) group of columns
+        for(int i = 0; i < rows; ++i)
+            for(int p = 0; p < depth; ++p)
+                for(int j = full; j < columns; ++j)
+                    C[i*ldc + j] += A[i*lda + p] * B[p*ldb + j];
+    }
+};
+
+#endif
+
+
+
+// Templates
+
+template <class T>
+void DynamicMatrix<T>::allocate(int rows, int columns)
+{
+    if(rows < 0 || columns < 0)
+        throw std::invalid_argument("DynamicMatrix: negative size");
+
+    this->rows    = rows;
+    this->columns = columns;
+    this->values  = NULL;
+    if(rows * columns > 0)
+    {
+        this->values = static_cast<T*>(::operator new(sizeof(T) * rows * columns,
+                                                      std::align_val_t(MATRIX_ALIGNMENT)));
+        std::fill(this->values, this->values + rows * columns, T());
+    }
+}
+
+
+template <class T>
+void DynamicMatrix<T>::deallocate()
+{
+    if(this->values != NULL)
+        ::operator delete(this->values, std::align_val_t(MATRIX_ALIGNMENT));
+    this->values = NULL;
+}
+
+
+/**
+ * Construct a rows x columns DynamicMatrix (of 0s)
+ *
+ * @param rows      The number of rows
+ * @param columns   The number of columns
+ * @throws          invalid_argument if rows or columns is negative
+ */
+template <class T>
+DynamicMatrix<T>::DynamicMatrix(int rows, int columns)
+{
+    allocate(rows, columns);
+}
+
+
+/**
+ * Construct a DynamicMatrix from a Matrix
+ *
+ * @param m   The Matrix
+ */
+template <class T>
+template <int R, int C>
+DynamicMatrix<T>::DynamicMatrix(const Matrix<R,C,T>& m)
+{
+    allocate(R, C);
+    std::copy(m.data(), m.data() + R*C, this->values);
+}
+
+
+template <class T>
+DynamicMatrix<T>::DynamicMatrix(const DynamicMatrix<T>& original)
+{
+    allocate(original.rows, original.columns);
+    std::copy(original.values, original.values + rows * columns, this->values);
+}
+
+
+template <class T>
+DynamicMatrix<T>::DynamicMatrix(DynamicMatrix<T>&& original) noexcept
+    : values(original.values), rows(original.rows), columns(original.columns)
+{
+    original.values  = NULL;
+    original.rows    = 0;
+    original.columns = 0;
+}
+
+
+template <class T>
+DynamicMatrix<T>::~DynamicMatrix()
+{
+    deallocate();
+}
+
+
+template <class T>
+DynamicMatrix<T>& DynamicMatrix<T>::operator=(const DynamicMatrix<T>& other)
+{
+    if(this != &other)
+    {
+        if(rows * columns != other.rows * other.columns)
+        {
+            deallocate();
+            allocate(other.rows, other.columns);
+        }
+        rows    = other.rows;
+        columns = other.columns;
+        std::copy(other.values, other.values + rows * columns, this->values);
+    }
+    return *this;
+}
+
+
+template <class T>
+DynamicMatrix<T>& DynamicMatrix<T>::operator=(DynamicMatrix<T>&& other) noexcept
+{
+    std::swap(values, other.values);
+    std::swap(rows, other.rows);
+    std::swap(columns, other.columns);
+    return *this;
+}
+
+
+template <class T>
+int DynamicMatrix<T>::getRows() const
+{
+    return rows;
+}
+
+
+template <class T>
+int DynamicMatrix<T>::getColumns() const
+{
+    return columns;
+}
+
+
+/**
+ * Get a particular element of this DynamicMatrix
+ *
+ * @param r   The row index
+ * @param c   The column index
+ * @throws    out_of_range if r or c are out of bounds
+ * @return    The value of the element
+ */
+template <class T>
+T DynamicMatrix<T>::get(int r, int c) const
+{
+    if(0 > r || r >= rows || 0 > c || c >= columns)
+        throw std::out_of_range("get(int,int): out of range");
+    return values[r*columns + c];
+}
+
+
+/**
+ * Access a particular element of this DynamicMatrix
+ *
+ * @param r   The row index
+ * @param c   The column index
+ * @throws    out_of_range if r or c are out of bounds
+ * @return    The element
+ */
+template <class T>
+T& DynamicMatrix<T>::operator()(int r, int c)
+{
+    if(0 > r || r >= rows || 0 > c || c >= columns)
+        throw std::out_of_range("operator(): out of range");
+    return values[r*columns + c];
+}
+
+
+template <class T>
+const T* DynamicMatrix<T>::data() const
+{
+    return values;
+}
+
+
+template <class T>
+T* DynamicMatrix<T>::data()
+{
+    return values;
+}
+
+
+/**
+ * Get an R x C block of this DynamicMatrix as a Matrix
+ *
+ * @param r   The row of the upper-left element of the block
+ * @param c   The column of the upper-left element of the block
+ * @throws    out_of_range if the block isn't inside this DynamicMatrix
+ * @return    The block
+ */
+template <class T>
+template <int R, int C>
+Matrix<R,C,T> DynamicMatrix<T>::getBlock(int r, int c) const
+{
+    if(0 > r || r + R > rows || 0 > c || c + C > columns)
+        throw std::out_of_range("getBlock(int,int): out of range");
+
+    Matrix<R,C,T> result;
+    for(int i = 0; i < R; ++i)
+        std::copy(values + (r + i)*columns + c, values + (r + i)*columns + c + C,
+                  result.rowPointer(i));
+    return result;
+}
+
+
+/**
+ * Copy a Matrix to an R x C block of this DynamicMatrix
+ *
+ * @param r   The row of the upper-left element of the block
+ * @param c   The column of the upper-left element of the block
+ * @param m   The Matrix
+ * @throws    out_of_range if the block isn't inside this DynamicMatrix
+ */
+template <class T>
+template <int R, int C>
+void DynamicMatrix<T>::setBlock(int r, int c, const Matrix<R,C,T>& m)
+{
+    if(0 > r || r + R > rows || 0 > c || c + C > columns)
+        throw std::out_of_range("setBlock(int,int): out of range");
+
+    for(int i = 0; i < R; ++i)
+        std::copy(m.rowPointer(i), m.rowPointer(i) + C, values + (r + i)*columns + c);
+}
+
+
+/**
+ * Multiply two DynamicMatrix objects (into an existing result, so that
+ * repeated products don't allocate)
+ *
+ * The product is computed in blocks of (at most) 256 columns of B and C
+ * and 128 rows of B (so that the block of B stays in the cache while it
+ * is multiplied by every row of A). Large products are split across
+ * threads by the blocks of columns.
+ *
+ * @param a        The m x k DynamicMatrix
+ * @param b        The k x n DynamicMatrix
+ * @param result   The m x n DynamicMatrix (which is resized if necessary)
+ * @throws         length_error if the sizes don't match
+ * @throws         invalid_argument if result is a or b
+ */
+template <class T>
+void multiply(const DynamicMatrix<T>& a, const DynamicMatrix<T>& b, DynamicMatrix<T>& result)
+{
+    const int BLOCK_COLUMNS = 256;
+    const int BLOCK_DEPTH   = 128;
+
+    if(a.columns != b.rows)
+        throw std::length_error("multiply: sizes don't match");
+    if(&result == &a || &result == &b)
+        throw std::invalid_argument("multiply: the result is an operand");
+
+    const int m = a.rows, k = a.columns, n = b.columns;
+    if(result.rows != m || result.columns != n)
+        result = DynamicMatrix<T>(m, n);
+    else
+        std::fill(result.values, result.values + m*n, T());
+
+    const T* A = a.values;
+    const T* B = b.values;
+    T*       C = result.values;
+
+    // Multiply the blocks of columns [first, last)
+    auto columnsOf = [=](int first, int last) {
+        for(int j = first; j < last; j += BLOCK_COLUMNS)
+        {
+            const int nc = std::min(BLOCK_COLUMNS, last - j);
+            for(int p = 0; p < k; p += BLOCK_DEPTH)
+            {
+                const int kc = std::min(BLOCK_DEPTH, k - p);
+                DynamicMatrixKernel<T>::multiplyAdd(A + p, k, B + p*n + j, n, C + j, n,
+                                                    m, kc, nc);
+            }
+        }
+    };
+
+    const int blocks  = (n + BLOCK_COLUMNS - 1) / BLOCK_COLUMNS;
+    int       threads = 1;
+    if((long)m * k * n >= DYNAMIC_MATRIX_PARALLEL_WORK)
+        threads = std::min<int>(blocks, std::max(1u, std::thread::hardware_concurrency()));
+
+    if(threads <= 1)
+    {
+        columnsOf(0, n);
+        return;
+    }
+
+    // Every thread gets a contiguous range of whole blocks
+    std::vector<std::thread> workers;
+    for(int t = 1; t < threads; ++t)
+    {
+        int first = std::min(n, (int)((long)blocks * t / threads) * BLOCK_COLUMNS);
+        int last  = std::min(n, (int)((long)blocks * (t + 1) / threads) * BLOCK_COLUMNS);
+        workers.push_back(std::thread(columnsOf, first, last));
+    }
+    columnsOf(0, std::min(n, (int)((long)blocks / threads) * BLOCK_COLUMNS));
+    for(size_t t = 0; t < workers.size(); ++t)
+        workers[t].join();
+}
+
+
+/**
+ * Multiply two DynamicMatrix objects
+ *
+ * @param a   The m x k DynamicMatrix
+ * @param b   The k x n DynamicMatrix
+ * @throws    length_error if the sizes don't match
+ * @return    The m x n product
+ */
+template <class T>
+DynamicMatrix<T> operator*(const DynamicMatrix<T>& a, const DynamicMatrix<T>& b)
+{
+    DynamicMatrix<T> result(a.getRows(), b.getColumns());
+
+    multiply(a, b, result);
+    return result;
+}
+
+
+/**
+ * Multiply a Matrix and a DynamicMatrix (e.g., transform every vertex of
+ * a mesh with one call)
+ *
+ * @param a   The R x C Matrix
+ * @param b   The C x n DynamicMatrix
+ * @throws    length_error if the sizes don't match
+ * @return    The R x n product
+ */
+template <int R, int C, class T>
+DynamicMatrix<T> operator*(const Matrix<R,C,T>& a, const DynamicMatrix<T>& b)
+{
+    return DynamicMatrix<T>(a) * b;
+}
+
+
+/**
+ * Determine whether two DynamicMatrix objects have the same size and
+ * equal (within TOLERANCE) elements
+ *
+ * @param a   One DynamicMatrix
+ * @param b   The other DynamicMatrix
+ * @return    true if they are equal; false otherwise
+ */
+template <class T>
+bool operator==(const DynamicMatrix<T>& a, const DynamicMatrix<T>& b)
+{
+    if(a.getRows() != b.getRows() || a.getColumns() != b.getColumns())
+        return false;
+
+    const T  tolerance = static_cast<T>(TOLERANCE);
+    const T* x = a.data();
+    const T* y = b.data();
+    for(int i = 0; i < a.getRows() * a.getColumns(); ++i)
+    {
+        if(x[i] - y[i] > tolerance || y[i] - x[i] > tolerance)
+            return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * Matrix expression benchmark
+ *
+ * Compares the eager operators with the lazy (expression template)
+ * operators. Along with the time, it reports the number of Matrix
+ * objects constructed, copied, and heap allocations per iteration.
+ *
+ * Build with -DMATRIX_COUNT_TEMPORARIES, for example:
+ *
+ *   g++ -std=c++17 -O2 -DMATRIX_COUNT_TEMPORARIES Expression_bench.cpp \
+ *       -lbenchmark -lpthread
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#include <cmath>
+#include <benchmark/benchmark.h>
+
+#include "AllocationCounter.h"
+#include "Matrix.hpp"
+
+/**
+ * A perspective, a translation, and two rotations (i.e., the factors
+ * used by Rasterizer3D::useThreePointPerspectiveView)
+ */
+class ViewFactors
+{
+  public:
+    Matrix<4,4>  p, t, rx, ry;
+
+    ViewFactors()
+    {
+        double phi = 0.3, theta = 0.7, d = 50;
+
+        p  = {1,0,  0,0,
+              0,1,  0,0,
+              0,0,  0,0,
+              0,0,1/d,1};
+        t  = {1,0,0,20,
+              0,1,0,100,
+              0,0,1,-50,
+              0,0,0,1};
+        rx = {1,        0,         0, 0,
+              0, cos(phi), -sin(phi), 0,
+              0, sin(phi),  cos(phi), 0,
+              0,        0,         0, 1};
+        ry = {cos(theta),0,sin(theta),0,
+                       0,1,         0,0,
+             -sin(theta),0,cos(theta),0,
+                       0,0,         0,1};
+    }
+};
+
+/**
+ * Reset the counters before the timed loop
+ */
+static void startCounting()
+{
+    AllocationCounter::reset();
+#ifdef MATRIX_COUNT_TEMPORARIES
+    MatrixCounters::constructed = 0;
+    MatrixCounters::copied      = 0;
+#endif
+}
+
+/**
+ * Report the counters (per iteration) after the timed loop
+ */
+static void reportCounts(benchmark::State& state)
+{
+    double n = (double)state.iterations();
+
+    state.counters["allocs/op"] = AllocationCounter::allocations / n;
+    state.counters["bytes/op"]  = AllocationCounter::bytes / n;
+#ifdef MATRIX_COUNT_TEMPORARIES
+    // The destination is constructed outside of the loop, so every
+    // construction counted here is a temporary
+    state.counters["temps/op"]  = MatrixCounters::constructed / n;
+    state.counters["copies/op"] = MatrixCounters::copied / n;
+#endif
+}
+
+static void BM_EagerViewChain(benchmark::State& state)
+{
+    ViewFactors  f;
+    Matrix<4,4>  view;
+
+    startCounting();
+    for (auto _ : state)
+    {
+        view = f.p * f.t * f.rx * f.ry;
+        benchmark::DoNotOptimize(view);
+    }
+    reportCounts(state);
+}
+BENCHMARK(BM_EagerViewChain);
+
+static void BM_LazyViewChain(benchmark::State& state)
+{
+    ViewFactors  f;
+    Matrix<4,4>  view;
+
+    startCounting();
+    for (auto _ : state)
+    {
+        view = lazy(f.p) * f.t * f.rx * f.ry;
+        benchmark::DoNotOptimize(view);
+    }
+    reportCounts(state);
+}
+BENCHMARK(BM_LazyViewChain);
+
+static void BM_EagerElementwise(benchmark::State& state)
+{
+    ViewFactors  f;
+    Matrix<4,4>  result;
+
+    startCounting();
+    for (auto _ : state)
+    {
+        result = f.rx + f.ry - 0.5 * f.t + f.p;
+        benchmark::DoNotOptimize(result);
+    }
+    reportCounts(state);
+}
+BENCHMARK(BM_EagerElementwise);
+
+static void BM_LazyElementwise(benchmark::State& state)
+{
+    ViewFactors  f;
+    Matrix<4,4>  result;
+
+    startCounting();
+    for (auto _ : state)
+    {
+        result = lazy(f.rx) + f.ry - 0.5 * lazy(f.t) + f.p;
+        benchmark::DoNotOptimize(result);
+    }
+    reportCounts(state);
+}
+BENCHMARK(BM_LazyElementwise);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,176 @@
+/**
+ * FixedPoint template
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __cs_fixed_point_hpp__
+#define __cs_fixed_point_hpp__
+
+#include <cstdint>
+#include <iostream>
+
+/**
+ * A signed fixed-point number that is stored in an int32_t with
+ * FRACTION_BITS bits after the binary point (e.g., FixedPoint<16> is
+ * Q15.16). It can be used as the element type of a Matrix:
+ *
+ *   Matrix<2,3,FixedPoint<16>> triangle;
+ *
+ * Sums and differences are exact (as long as they don't overflow) and
+ * products are rounded to the nearest representable value, so results
+ * don't depend on the compiler or the instruction set.
+ *
+ * Note: Integers convert implicitly (since they are represented exactly)
+ * but floating-point values must be converted explicitly.
+ */
+template <int FRACTION_BITS>
+class FixedPoint
+{
+    static_assert(0 < FRACTION_BITS && FRACTION_BITS < 31,
+                  "FixedPoint: FRACTION_BITS must be in [1,30]");
+
+  private:
+    int32_t raw;
+
+    static constexpr int32_t ONE = int32_t(1) << FRACTION_BITS;
+
+  public:
+    /**
+     * Construct a FixedPoint with the value 0
+     */
+    constexpr FixedPoint(): raw(0) {}
+
+    /**
+     * Construct a FixedPoint from an integer
+     *
+     * @param value   The integer
+     */
+    constexpr FixedPoint(int value): raw(value * ONE) {}
+
+    /**
+     * Construct a FixedPoint from a double (rounded to the nearest
+     * representable value)
+     *
+     * @param value   The double
+     */
+    constexpr explicit FixedPoint(double value)
+        : raw(static_cast<int32_t>(value * ONE + (value < 0 ? -0.5 : 0.5)))
+    {
+    }
+
+    /**
+     * Construct a FixedPoint from its representation
+     *
+     * @param raw   The representation (i.e., the value times 2^FRACTION_BITS)
+     * @return      The FixedPoint
+     */
+    static constexpr FixedPoint fromRaw(int32_t raw)
+    {
+        FixedPoint result;
+        result.raw = raw;
+        return result;
+    }
+
+    /**
+     * Get the representation of this FixedPoint
+     *
+     * @return   The value times 2^FRACTION_BITS
+     */
+    constexpr int32_t getRaw() const
+    {
+        return raw;
+    }
+
+    /**
+     * Convert this FixedPoint to a double (which is exact)
+     */
+    constexpr explicit operator double() const
+    {
+        return static_cast<double>(raw) / ONE;
+    }
+
+    constexpr FixedPoint operator-() const
+    {
+        return fromRaw(-raw);
+    }
+
+    constexpr FixedPoint& operator+=(FixedPoint other)
+    {
+        raw += other.raw;
+        return *this;
+    }
+
+    constexpr FixedPoint& operator-=(FixedPoint other)
+    {
+        raw -= other.raw;
+        return *this;
+    }
+
+    constexpr FixedPoint& operator*=(FixedPoint other)
+    {
+        // Multiply in 64 bits and round (half up) back to FRACTION_BITS
+        int64_t product = static_cast<int64_t>(raw) * other.raw;
+        raw = static_cast<int32_t>((product + (int64_t(1) << (FRACTION_BITS - 1)))
+                                   >> FRACTION_BITS);
+        return *this;
+    }
+
+    friend constexpr FixedPoint operator+(FixedPoint a, FixedPoint b)
+    {
+        return a += b;
+    }
+
+    friend constexpr FixedPoint operator-(FixedPoint a, FixedPoint b)
+    {
+        return a -= b;
+    }
+
+    friend constexpr FixedPoint operator*(FixedPoint a, FixedPoint b)
+    {
+        return a *= b;
+    }
+
+    friend constexpr bool operator==(FixedPoint a, FixedPoint b)
+    {
+        return a.raw == b.raw;
+    }
+
+    friend constexpr bool operator!=(FixedPoint a, FixedPoint b)
+    {
+        return a.raw != b.raw;
+    }
+
+    friend constexpr bool operator<(FixedPoint a, FixedPoint b)
+    {
+        return a.raw < b.raw;
+    }
+
+    friend constexpr bool operator>(FixedPoint a, FixedPoint b)
+    {
+        return a.raw > b.raw;
+    }
+
+    friend constexpr bool operator<=(FixedPoint a, FixedPoint b)
+    {
+        return a.raw <= b.raw;
+    }
+
+    friend constexpr bool operator>=(FixedPoint a, FixedPoint b)
+    {
+        return a.raw >= b.raw;
+    }
+
+    friend constexpr FixedPoint abs(FixedPoint a)
+    {
+        return a.raw < 0 ? -a : a;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, FixedPoint a)
+    {
+        return out << static_cast<double>(a);
+    }
+};
+
+#endif
@@ -0,0 +1,309 @@
+/**
+ * LU decomposition
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __cs_lu_decomposition_hpp__
+#define __cs_lu_decomposition_hpp__
+
+#include <limits>
+#include <type_traits>
+
+/**
+ * The LU decomposition (with partial pivoting) of an RC x RC Matrix, a.
+ * That is, PA = LU, where P is a permutation matrix, L is a unit lower
+ * triangular matrix and U is an upper triangular matrix.
+ *
+ * The decomposition takes O(RC^3) operations and is stored in place
+ * (L below the diagonal and U on and above it), so it never allocates.
+ * Once it has been computed it can be used to calculate the determinant,
+ * to solve systems of equations, and to calculate the inverse.
+ *
+ * Example of use:
+ *
+ *   LUDecomposition<4> lu(view);
+ *   Matrix<4,1>        world = lu.solve(screen);
+ *
+ * Note: The elements must be floating point (since the algorithm divides
+ * by the pivots and compares them to the rounding error).
+ *
+ * Note: This file is included at the end of Matrix.hpp and should not be
+ * included directly.
+ */
+template <int RC, class T>
+class LUDecomposition
+{
+    static_assert(std::is_floating_point<T>::value,
+                  "LUDecomposition requires floating-point elements");
+
+  private:
+    Matrix<RC,RC,T>  lu;
+    int              pivots[RC];
+    int              sign;
+    bool             singular;
+
+  public:
+    /**
+     * Decompose an RC x RC Matrix
+     *
+     * @param a   The Matrix
+     */
+    LUDecomposition(const Matrix<RC,RC,T>& a);
+
+    /**
+     * Calculate the determinant of the decomposed Matrix
+     *
+     * @return   The determinant (which is 0 only if a pivot is exactly 0)
+     */
+    T det() const;
+
+    /**
+     * Determine whether the decomposed Matrix is (numerically) singular
+     * (i.e., too close to singular for solve() and inverse())
+     *
+     * @return   true if it is singular; false otherwise
+     */
+    bool isSingular() const;
+
+    /**
+     * Solve AX = B for X, where A is the decomposed Matrix
+     *
+     * @param b   The RC x C Matrix B
+     * @throws    domain_error if the decomposed Matrix is singular
+     * @return    X
+     */
+    template <int C>
+    Matrix<RC,C,T> solve(const Matrix<RC,C,T>& b) const;
+
+    /**
+     * Calculate the inverse of the decomposed Matrix
+     *
+     * @throws    domain_error if the decomposed Matrix is singular
+     * @return    The inverse
+     */
+    Matrix<RC,RC,T> inverse() const;
+};
+
+
+/**
+ * Calculate the inverse of an RC x RC Matrix
+ *
+ * @param a   The Matrix
+ * @throws    domain_error if the Matrix is singular
+ * @return    The inverse of a
+ */
+template <int RC, class T>
+Matrix<RC,RC,T> inverse(const Matrix<RC,RC,T>& a);
+
+/**
+ * Solve the system of equations AX = B
+ *
+ * @param a   The RC x RC Matrix A
+ * @param b   The RC x C Matrix B
+ * @throws    domain_error if A is singular
+ * @return    The RC x C Matrix X
+ */
+template <int RC, int C, class T>
+Matrix<RC,C,T> solve(const Matrix<RC,RC,T>& a, const Matrix<RC,C,T>& b);
+
+
+
+// Templates
+
+/**
+ * Decompose an RC x RC Matrix using Doolittle's algorithm with partial
+ * pivoting (i.e., at each step the row with the largest element in the
+ * current column is swapped into place)
+ *
+ * The Matrix is treated as singular (by solve() and inverse(), but not
+ * by det()) if a pivot is smaller than the rounding error relative to
+ * the largest element of its own row of the Matrix (so that a badly
+ * scaled Matrix, e.g., diag(1e10, 1e-10, 1), isn't).
+ *
+ * @param a   The Matrix
+ */
+template <int RC, class T>
+LUDecomposition<RC,T>::LUDecomposition(const Matrix<RC,RC,T>& a)
+    : lu(a)
+{
+    T (*m)[RC] = lu.values;
+    T   scale[RC];
+
+    // The largest element of each row (which is swapped with the row)
+    for(int r = 0; r < RC; ++r)
+    {
+        scale[r] = T();
+        for(int c = 0; c < RC; ++c)
+            scale[r] = fmax(scale[r], fabs(m[r][c]));
+    }
+
+    sign     = 1;
+    singular = false;
+    for(int k = 0; k < RC; ++k)
+    {
+        // Find the pivot
+        int p = k;
+        for(int r = k + 1; r < RC; ++r)
+        {
+            if(fabs(m[r][k]) > fabs(m[p][k])) p = r;
+        }
+        pivots[k] = p;
+
+        if(p != k)
+        {
+            for(int c = 0; c < RC; ++c)
+            {
+                T temp = m[k][c];
+                m[k][c] = m[p][c];
+                m[p][c] = temp;
+            }
+            T temp   = scale[k];
+            scale[k] = scale[p];
+            scale[p] = temp;
+            sign = -sign;
+        }
+
+        if(fabs(m[k][k]) <= RC * scale[k] * std::numeric_limits<T>::epsilon())
+            singular = true;
+
+        // (the elements below a pivot of 0 are 0 too)
+        if(m[k][k] == T())
+            continue;
+
+        // Eliminate the elements below the pivot
+        for(int r = k + 1; r < RC; ++r)
+        {
+            T factor = m[r][k] / m[k][k];
+            m[r][k] = factor;
+            for(int c = k + 1; c < RC; ++c)
+                m[r][c] -= factor * m[k][c];
+        }
+    }
+}
+
+
+/**
+ * Calculate the determinant of the decomposed Matrix (i.e., the
+ * product of the diagonal of U, with the sign of the permutation)
+ *
+ * @return   The determinant (which is 0 only if a pivot is exactly 0)
+ */
+template <int RC, class T>
+T LUDecomposition<RC,T>::det() const
+{
+    T result = sign;
+    for(int k = 0; k < RC; ++k)
+        result *= lu.values[k][k];
+    return result;
+}
+
+
+/**
+ * Determine whether the decomposed Matrix is (numerically) singular
+ *
+ * @return   true if it is singular; false otherwise
+ */
+template <int RC, class T>
+bool LUDecomposition<RC,T>::isSingular() const
+{
+    return singular;
+}
+
+
+/**
+ * Solve AX = B for X, where A is the decomposed Matrix (by forward
+ * substitution with L and then back substitution with U)
+ *
+ * @param b   The RC x C Matrix B
+ * @throws    domain_error if the decomposed Matrix is singular
+ * @return    X
+ */
+template <int RC, class T>
+template <int C>
+Matrix<RC,C,T> LUDecomposition<RC,T>::solve(const Matrix<RC,C,T>& b) const
+{
+    if(singular)
+        throw std::domain_error("solve: singular matrix");
+
+    const T      (*m)[RC] = lu.values;
+    Matrix<RC,C,T>   x(b);
+    T            (*v)[C] = x.values;
+
+    // Apply the permutation
+    for(int k = 0; k < RC; ++k)
+    {
+        if(pivots[k] != k)
+        {
+            for(int c = 0; c < C; ++c)
+            {
+                T temp = v[k][c];
+                v[k][c] = v[pivots[k]][c];
+                v[pivots[k]][c] = temp;
+            }
+        }
+    }
+
+    // Solve LY = PB
+    for(int r = 1; r < RC; ++r)
+        for(int k = 0; k < r; ++k)
+            for(int c = 0; c < C; ++c)
+                v[r][c] -= m[r][k] * v[k][c];
+
+    // Solve UX = Y
+    for(int r = RC - 1; r >= 0; --r)
+    {
+        for(int k = r + 1; k < RC; ++k)
+            for(int c = 0; c < C; ++c)
+                v[r][c] -= m[r][k] * v[k][c];
+        for(int c = 0; c < C; ++c)
+            v[r][c] /= m[r][r];
+    }
+
+    return x;
+}
+
+
+/**
+ * Calculate the inverse of the decomposed Matrix (i.e., solve AX = I)
+ *
+ * @throws    domain_error if the decomposed Matrix is singular
+ * @return    The inverse
+ */
+template <int RC, class T>
+Matrix<RC,RC,T> LUDecomposition<RC,T>::inverse() const
+{
+    return solve(identity<RC,T>());
+}
+
+
+/**
+ * Calculate the inverse of an RC x RC Matrix
+ *
+ * @param a   The Matrix
+ * @throws    domain_error if the Matrix is singular
+ * @return    The inverse of a
+ */
+template <int RC, class T>
+Matrix<RC,RC,T> inverse(const Matrix<RC,RC,T>& a)
+{
+    return LUDecomposition<RC,T>(a).inverse();
+}
+
+
+/**
+ * Solve the system of equations AX = B
+ *
+ * @param a   The RC x RC Matrix A
+ * @param b   The RC x C Matrix B
+ * @throws    domain_error if A is singular
+ * @return    The RC x C Matrix X
+ */
+template <int RC, int C, class T>
+Matrix<RC,C,T> solve(const Matrix<RC,RC,T>& a, const Matrix<RC,C,T>& b)
+{
+    return LUDecomposition<RC,T>(a).solve(b);
+}
+
+#endif
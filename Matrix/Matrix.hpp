@@ -13,70 +13,160 @@
 
 #define TOLERANCE   0.0001
 
+// The byte alignment of the (inline) element storage of every Matrix.
+// 32 bytes is the width of an AVX register, so that a row of four
+// doubles can be loaded with a single instruction.
+#ifndef MATRIX_ALIGNMENT
+#define MATRIX_ALIGNMENT   32
+#endif
+
 #include <iostream>
 #include <cmath>
 #include <initializer_list>
 #include <math.h>
 #include <stdexcept>
+#include "MatrixExpression.hpp"
+#include "MatrixView.hpp"
 
 using namespace std;
 
 
+// The unchecked accessors (i.e., get<r,c>(), rowPointer() and
+// columnPointer()) only check their indexes when MATRIX_RANGE_CHECKS
+// is defined (e.g., in debug builds). The checked accessors (i.e.,
+// get() and operator()) always do.
+#ifdef MATRIX_RANGE_CHECKS
+#define MATRIX_CHECK_RANGE(condition, message) \
+   do { if (!(condition)) throw std::out_of_range(message); } while(0)
+#else
+#define MATRIX_CHECK_RANGE(condition, message)   ((void)0)
+#endif
+
+
+// When MATRIX_COUNT_TEMPORARIES is defined every Matrix that is
+// constructed (and every one that is copied) is counted. This is only
+// intended for benchmarks and tests (since a counted Matrix can't be
+// constructed at compile time).
+#ifdef MATRIX_COUNT_TEMPORARIES
+struct MatrixCounters
+{
+   static inline long constructed = 0;
+   static inline long copied      = 0;
+};
+#define MATRIX_COUNT(counter)   (++MatrixCounters::counter)
+#else
+#define MATRIX_COUNT(counter)
+#endif
+
+
+// Whether the current evaluation is happening at compile time (which
+// can be used to avoid operations that can't be evaluated at compile
+// time)
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define MATRIX_IS_CONSTANT_EVALUATED()   __builtin_is_constant_evaluated()
+#endif
+#endif
+#ifndef MATRIX_IS_CONSTANT_EVALUATED
+#define MATRIX_IS_CONSTANT_EVALUATED()   false
+#endif
+
+
 // Prototype of the Matrix class 
 // (so that it can be used in the friend prototypes)
-template <int R, int C> class Matrix;
+//
+// Note: The element type, T, defaults to double (the default is
+// specified in the prototype in MatrixExpression.hpp)
+template <int R, int C, class T> class Matrix;
+
+
+// Whether all of the Args can be converted to elements of type T (so
+// that the element constructor doesn't compete with the copy, move
+// and conversion constructors)
+template <class T, class... Args>
+struct MatrixElements
+{
+    static constexpr bool value =
+        (std::is_arithmetic<Args>::value && ...) ||
+        (std::is_same<Args, T>::value && ...);
+};
+
+
+// The type of the scalar in scalar-Matrix operations (e.g., 2.0 * a)
+//
+// Note: Using this (rather than T) keeps the scalar from being used
+// to deduce T, so that 2.0 * a works for a Matrix of float
+template <class T>
+struct MatrixScalar
+{
+    typedef T type;
+};
+
 
-template <int R, int C>
-void printMatrix(const Matrix<R,C>& a);
+template <int R, int C, class T>
+void printMatrix(const Matrix<R,C,T>& a);
 // Prototypes of friend functions 
-template <int RC>
-double cof(const Matrix<RC,RC>& a, int i, int j);
+template <int RC, class T>
+T cof(const Matrix<RC,RC,T>& a, int i, int j);
 
 double det(double a);
 
-template <int RC>
-double det(const Matrix<RC,RC>& a);
+template <int RC, class T>
+constexpr T det(const Matrix<RC,RC,T>& a);
+
+template <int R, int C, class T>
+constexpr T dot(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b);
+
+template <int RC, class T = double>
+constexpr Matrix<RC,RC,T> identity();   
+
+template <int RC, class T>
+T matrix_minor(const Matrix<RC,RC,T>& a, int i, int j);
 
-template<int R, int C>
-double dot(const Matrix<R,C>& a, const Matrix<R,C>& b);
+template <int RLR, int CL, int CR, class T>
+constexpr Matrix<RLR,CL+CR,T> operator|(const Matrix<RLR,CL,T>& a, const Matrix<RLR,CR,T>& b);   
 
-template <int RC>
-Matrix<RC,RC> identity();   
+template <int R, int C, class T>
+constexpr Matrix<R,C,T> operator+(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b);
 
-template <int RC>
-double matrix_minor(const Matrix<RC,RC>& a, int i, int j);
+template <int R, int C, class T>
+constexpr Matrix<R,C,T> operator-(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b);
 
-template <int RLR, int CL, int CR>
-Matrix<RLR,CL+CR> operator|(const Matrix<RLR,CL>& a, const Matrix<RLR,CR>& b);   
+template <int RL, int CLRR, int CR, class T>
+constexpr Matrix<RL,CR,T> operator*(const Matrix<RL,CLRR,T>& a, const Matrix<CLRR,CR,T>& b);
 
-template <int R, int C>
-Matrix<R,C> operator+(const Matrix<R,C>& a, const Matrix<R,C>& b);
+template <int R, int C, class T>
+constexpr Matrix<R,C,T> operator*(typename MatrixScalar<T>::type k, const Matrix<R,C,T>& a);
 
-template <int R, int C>
-Matrix<R,C> operator-(const Matrix<R,C>& a, const Matrix<R,C>& b);
+template <int R, int C, class T>
+constexpr Matrix<R,C,T> operator*(const Matrix<R,C,T>& a, typename MatrixScalar<T>::type k);
 
-template <int RL, int CLRR, int CR>
-Matrix<RL,CR> operator*(const Matrix<RL,CLRR>& a, const Matrix<CLRR,CR>& b);
+template <int R, int C, class T>
+constexpr bool operator==(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b);
 
-template <int R, int C>
-Matrix<R,C> operator*(double k, const Matrix<R,C>& a);
+template <int R, int C, class T>
+constexpr bool operator!=(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b);
 
-template <int R, int C>
-Matrix<R,C> operator*(const Matrix<R,C>& a, double k);
+template <class T>
+T submatrix(const Matrix<2,2,T>& a, int i, int j);
 
-template <int R, int C>
-bool operator==(const Matrix<R,C>& a, const Matrix<R,C>& b);
+template <int R, int C, class T>
+Matrix<R-1,C-1,T> submatrix(const Matrix<R,C,T>& a, int i, int j);
 
-template <int R, int C>
-bool operator!=(const Matrix<R,C>& a, const Matrix<R,C>& b);
+template <int R, int C, class T>
+constexpr Matrix<C,R,T> trans(const Matrix<R,C,T>& a);
 
-double submatrix(const Matrix<2,2>& a, int i, int j);
+template <int RL, int CLRR, int CR, class T>
+struct MatrixMultiply;
 
-template <int R, int C>
-Matrix<R-1,C-1> submatrix(const Matrix<R,C>& a, int i, int j);
+template <int RL, int CLRR, int CR, class T>
+struct GenericMatrixMultiply;
 
-template <int R, int C>
-Matrix<C,R> trans(const Matrix<R,C>& a);
+template <int RC, class T>
+struct MatrixDeterminant;
+
+template <int RC, class T = double>
+class LUDecomposition;
 
 
 
@@ -87,38 +177,104 @@ Matrix<C,R> trans(const Matrix<R,C>& a);
 //
 // The parameters RALL and CALL correspond to the number of rows and
 // columns, respectively, in all of the methods/functions that
-// have sizes in common
-template <int RALL, int CALL>
-class Matrix
+// have sizes in common, and TALL corresponds to the type of the
+// elements (e.g., double, float, or a fixed-point type)
+//
+// Note: The elements are stored inline (i.e., in the object itself) in
+// one contiguous, row-major, aligned array. Hence, constructing,
+// copying, and destroying a Matrix never touches the heap.
+template <int RALL, int CALL, class TALL>
+class Matrix: public MatrixExpression<Matrix<RALL,CALL,TALL>,RALL,CALL>
 {
-  protected:
-   double**            values;   
-   int                 columns, rows;
-   
+   static_assert(RALL > 0 && CALL > 0, "Matrix dimensions must be positive");
+
+   template <class E, int R, int C>
+   friend class MatrixExpression;
+
+   template <int R, int C, class T>
+   friend class Matrix;
+
+   template <int RL, int CLRR, int CR, class T>
+   friend struct MatrixMultiply;
+
+   template <int RL, int CLRR, int CR, class T>
+   friend struct GenericMatrixMultiply;
 
-   void allocateMemory(int rows, int columns);
-   void deallocateMemory();
-   void setValues(double value);
-   void setValues(const Matrix& other);   
-   void setValues(const double* values);   
-   void setValues(double** values);
+   template <int RC, class T>
+   friend struct MatrixDeterminant;
+
+   template <int RC, class T>
+   friend class LUDecomposition;
+
+  protected:
+   alignas(MATRIX_ALIGNMENT) TALL values[RALL][CALL];
+
+   constexpr TALL coeff(int r, int c) const;
+   bool refersTo(const void* m) const;
+   constexpr void setValues(TALL value);
+   constexpr void setValues(const Matrix& other);   
+   constexpr void setValues(const TALL* values);   
+   template <class... Args>
+   constexpr void setElements(Args... args);
    
 
   public:
+    // The type of the elements (see MatrixExpression.hpp)
+    typedef TALL Scalar;
+
     /**
      * Default Constructor for RALL x CALL Matrix objects
      */
-    Matrix<RALL,CALL>();
+    constexpr Matrix<RALL,CALL,TALL>();
 
     /**
      * Copy Constructor for RALL x CALL Matrix objects
      */
-    Matrix<RALL,CALL>(const Matrix<RALL,CALL>& original);
-    
+    constexpr Matrix<RALL,CALL,TALL>(const Matrix<RALL,CALL,TALL>& original);
+
+    /**
+     * Construct a RALL x CALL Matrix from a row-major array of values
+     * (in a way that can be evaluated at compile time)
+     *
+     * @param m   The values
+     */
+    constexpr explicit Matrix<RALL,CALL,TALL>(const TALL (&m)[RALL*CALL]);
+
+    /**
+     * Construct a RALL x CALL Matrix from its elements (in row-major
+     * order), e.g., Matrix<2,1> p(x, y). The number of elements is
+     * checked at compile time.
+     *
+     * @param args   The RALL*CALL elements
+     */
+    template <class... Args, class = typename std::enable_if<
+                  (sizeof...(Args) > 1) &&
+                  MatrixElements<TALL,Args...>::value>::type>
+    constexpr Matrix<RALL,CALL,TALL>(Args... args);
+
+    /**
+     * Move Constructor for RALL x CALL Matrix objects
+     */
+    constexpr Matrix<RALL,CALL,TALL>(Matrix<RALL,CALL,TALL>&& original) noexcept;
+
+    /**
+     * Construct a RALL x CALL Matrix by converting the elements of a
+     * RALL x CALL Matrix with a different element type (e.g., from
+     * double to float)
+     *
+     * @param original  The Matrix to convert
+     */
+    template <class U>
+    constexpr explicit Matrix<RALL,CALL,TALL>(const Matrix<RALL,CALL,U>& original);
+
     /**
-     * Destructor for RALL x CALL Matrix objects
+     * Construct a RALL x CALL Matrix from (i.e., by evaluating) an
+     * expression
+     *
+     * @param e   The expression
      */
-    ~Matrix<RALL,CALL>();
+    template <class E>
+    Matrix<RALL,CALL,TALL>(const MatrixExpression<E,RALL,CALL>& e);
     
     /**
      * Calculate the cofactor of an RC x RC matrix (i.e., the signed
@@ -130,22 +286,9 @@ class Matrix
      * @throws    out_of_range if i or j are out of bounds
      * @return    The cofactor
      */
-    template <int RC>
-    friend double cof(const Matrix<RC,RC>& a, int i, int j);
+    template <int RC, class T>
+    friend T cof(const Matrix<RC,RC,T>& a, int i, int j);
 
-    /**
-     * Calculate the determinant of a scalar (which is useful when
-     * calculating the determinant of a matrix using cofactors)
-     *
-     * Note: This is a function template so that it is 1:1 with the class
-     * (which avoid problems of duplicate definitions when linking)
-     *
-     * @param a   The value of the scalar
-     * @return    The determinant of a (which is just a)
-     */
-    template <int R, int C>
-    friend double det(double a);
-    
     /**
      * Calculate the determinant of an RC x RC matrix
      *
@@ -153,8 +296,8 @@ class Matrix
      * @throws    length_error if the Matrix is smaller than 2x2
      * @return    The value of the determinant
      */
-    template <int RC>
-    friend double det(const Matrix<RC,RC>& a);
+    template <int RC, class T>
+    friend constexpr T det(const Matrix<RC,RC,T>& a);
     
     /**
      * Calculate the dot product (more commonly known as the scalar product)
@@ -165,8 +308,8 @@ class Matrix
      * @param b  The right Matrix
      * @return   The scalar product
      */
-    template<int R, int C>
-    friend double dot(const Matrix<R,C>& a, const Matrix<R,C>& b);
+    template <int R, int C, class T>
+    friend constexpr T dot(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b);
     
     /**
      * Get a particular element of this RALL x CALL Matrix.
@@ -176,7 +319,7 @@ class Matrix
      * @throws    out_of_range if r or c are out of bounds
      * @return    The value of the element
      */
-    double get(int r, int c) const;
+    constexpr TALL get(int r, int c) const;
     
     /**
      * Get a particular element of this RALL x CALL Matrix if it contains
@@ -187,7 +330,87 @@ class Matrix
      * @throws    length_error if this is neither a single row nor single column
      * @return    The value of the element
      */
-    double get(int i) const;
+    constexpr TALL get(int i) const;
+
+    /**
+     * Get a particular element of this RALL x CALL Matrix, where the
+     * indexes are known at compile time (so they are checked at
+     * compile time and never at run time)
+     *
+     * Example of use:
+     *
+     *     x = p.get<0,0>();
+     *
+     * @param r   The row index
+     * @param c   The column index
+     * @return    The value of the element
+     */
+    template <int r, int c>
+    constexpr TALL get() const;
+
+    /**
+     * Access a particular element of this RALL x CALL Matrix, where
+     * the indexes are known at compile time
+     *
+     * Example of use:
+     *
+     *     p.get<1,0>() = 5.0;
+     *
+     * @param r   The row index
+     * @param c   The column index
+     * @return    The element
+     */
+    template <int r, int c>
+    constexpr TALL& get();
+
+    /**
+     * Get a particular element of this RALL x CALL Matrix if it contains
+     * a single row or single column, where the index is known at
+     * compile time
+     *
+     * @param i   The index
+     * @return    The value of the element
+     */
+    template <int i>
+    constexpr TALL get() const;
+
+    /**
+     * Get a pointer to the (contiguous, row-major) elements of this
+     * RALL x CALL Matrix
+     *
+     * @return    A pointer to the element in row 0 and column 0
+     */
+    constexpr const TALL* data() const;
+    constexpr TALL*       data();
+
+    /**
+     * Get a pointer to a row of this RALL x CALL Matrix (i.e., to CALL
+     * contiguous elements)
+     *
+     * @param r   The row index
+     * @throws    out_of_range if r is out of bounds (only if
+     *            MATRIX_RANGE_CHECKS is defined)
+     * @return    A pointer to the first element of the row
+     */
+    constexpr const TALL* rowPointer(int r) const;
+    constexpr TALL*       rowPointer(int r);
+
+    /**
+     * Get a pointer to a column of this RALL x CALL Matrix (i.e., to
+     * RALL elements that are CALL elements apart)
+     *
+     * Example of use:
+     *
+     *     const double* y = m.columnPointer(j);
+     *     sum = y[0*m.getColumns()] + y[1*m.getColumns()];
+     *
+     * @param c   The column index
+     * @throws    out_of_range if c is out of bounds (only if
+     *            MATRIX_RANGE_CHECKS is defined)
+     * @return    A pointer to the first element of the column
+     */
+    constexpr const TALL* columnPointer(int c) const;
+    constexpr TALL*       columnPointer(int c);
     
     /**
      * Get a RALL x 1 column of this RALL x CALL Matrix
@@ -195,21 +418,54 @@ class Matrix
      * @param c   The index of the column (0-based)
      * @return    The column
      */
-    Matrix<RALL,1> getColumn(int c) const;   
+    constexpr Matrix<RALL,1,TALL> getColumn(int c) const;   
+
+    /**
+     * Get a (zero-copy) view of a column of this RALL x CALL Matrix
+     *
+     * @param c   The index of the column (0-based)
+     * @throws    out_of_range if c is out of bounds
+     * @return    The view
+     */
+    constexpr MatrixView<RALL,1,TALL> columnView(int c) const;
+
+    /**
+     * Get a (zero-copy) view of a row of this RALL x CALL Matrix
+     *
+     * @param r   The index of the row (0-based)
+     * @throws    out_of_range if r is out of bounds
+     * @return    The view
+     */
+    constexpr MatrixView<1,CALL,TALL> rowView(int r) const;
+
+    /**
+     * Get a (zero-copy) view of an R x C block of this RALL x CALL Matrix
+     *
+     * Example of use:
+     *
+     *     Matrix<3,3> linear = view.blockView<3,3>(0,0);
+     *
+     * @param r   The index of the first row of the block
+     * @param c   The index of the first column of the block
+     * @throws    out_of_range if the block is out of bounds
+     * @return    The view
+     */
+    template <int R, int C>
+    constexpr MatrixView<R,C,TALL> blockView(int r, int c) const;
     
     /**
      * Get the number of columns in this RALL x CALL Matrix
      *
      * @return  The number of columns (i.e., CALL)
      */
-    int getColumns() const;
+    constexpr int getColumns() const;
     
     /**
      * Get the number of rows in this RALL x CALL Matrix
      *
      * @return  The number of rows (i.e., RALL)
      */
-    int getRows() const;
+    constexpr int getRows() const;
     
     /**
      * Create and return an RC x RC identity matrix
@@ -219,8 +475,8 @@ class Matrix
      *
      * @return        An identity Matrix
      */
-    template <int RC>
-    friend Matrix<RC,RC> identity();   
+    template <int RC, class T>
+    friend constexpr Matrix<RC,RC,T> identity();   
     
     /**
      * Calculate the minor of an RC x RC Matrix (i.e., the determinant of
@@ -231,12 +487,12 @@ class Matrix
      * @param j   The index of the column to exclude
      * @return    The minor
      */
-    template <int RC>
-    friend double matrix_minor(const Matrix<RC,RC>& a, int i, int j);
+    template <int RC, class T>
+    friend T matrix_minor(const Matrix<RC,RC,T>& a, int i, int j);
   
 
-    template <int R, int C>
-    friend void printMatrix(const Matrix<R,C>& a);
+    template <int R, int C, class T>
+    friend void printMatrix(const Matrix<R,C,T>& a);
     /**
      * Access an element of this RALL x CALL Matrix using the 
      * function-call operator.
@@ -246,7 +502,7 @@ class Matrix
      * @throws    out_of_range if r or c are out of bounds
      * @return    The value of the element
      */
-    double& operator()(int r, int c);
+    constexpr TALL& operator()(int r, int c);
     
     /**
      * Access a particular element of this RALL x CALL Matrix using
@@ -258,7 +514,7 @@ class Matrix
      * @throws    length_error if this is neither a single row nor single column
      * @return    The the element
      */
-    double& operator()(int i);
+    constexpr TALL& operator()(int i);
    
 
     /**
@@ -267,7 +523,17 @@ class Matrix
      * @param m   The initializer_list containing the values
      * @return    The Matrix referred to by this
      */
-    Matrix<RALL,CALL>& operator=(std::initializer_list<double> values);
+    Matrix<RALL,CALL,TALL>& operator=(std::initializer_list<TALL> values);
+
+    /**
+     * Assign RALL*CALL elements (in row-major order) to this Matrix. The
+     * number of elements is checked at compile time.
+     *
+     * @param args   The elements
+     * @return       The Matrix referred to by this
+     */
+    template <class... Args>
+    constexpr Matrix<RALL,CALL,TALL>& assign(Args... args);
     
     /**
      * Assign another RALL x CALL Matrix to this RALL x CALL Matrix
@@ -275,7 +541,24 @@ class Matrix
      * @param other   The Matrix to copy
      * @return        The Matrix referred to by this
      */
-    Matrix<RALL,CALL>& operator=(const Matrix<RALL,CALL>& other);
+    constexpr Matrix<RALL,CALL,TALL>& operator=(const Matrix<RALL,CALL,TALL>& other);
+
+    /**
+     * Move another RALL x CALL Matrix into this RALL x CALL Matrix
+     *
+     * @param other   The Matrix to move
+     * @return        The Matrix referred to by this
+     */
+    constexpr Matrix<RALL,CALL,TALL>& operator=(Matrix<RALL,CALL,TALL>&& other) noexcept;
+
+    /**
+     * Evaluate an expression into this RALL x CALL Matrix
+     *
+     * @param e   The expression
+     * @return    The Matrix referred to by this
+     */
+    template <class E>
+    Matrix<RALL,CALL,TALL>& operator=(const MatrixExpression<E,RALL,CALL>& e);
     
     /**
      * Concatenate the columns of the RLR x CL Matrix a and the 
@@ -286,9 +569,9 @@ class Matrix
      * @param b   The right Matrix
      * @return    a concatenated with b
      */
-    template <int RLR, int CL, int CR>
-    friend Matrix<RLR,CL+CR> operator|(const Matrix<RLR,CL>& a, 
-                                       const Matrix<RLR,CR>& b);   
+    template <int RLR, int CL, int CR, class T>
+    friend constexpr Matrix<RLR,CL+CR,T> operator|(const Matrix<RLR,CL,T>& a, 
+                                       const Matrix<RLR,CR,T>& b);   
     
     /**
      * Add the R x C Matrix a and the R x C Matrix b
@@ -297,8 +580,8 @@ class Matrix
      * @param b   The right Matrix
      * @return    a+b
      */
-    template <int R, int C>
-    friend Matrix<R,C> operator+(const Matrix<R,C>& a, const Matrix<R,C>& b);
+    template <int R, int C, class T>
+    friend constexpr Matrix<R,C,T> operator+(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b);
     
     /**
      * Subtract the R x C Matrix b from the R x C matrix a (component by
@@ -308,8 +591,8 @@ class Matrix
      * @param b   The right Matrix
      * @return    a-b
      */
-    template <int R, int C>
-    friend Matrix<R,C> operator-(const Matrix<R,C>& a, const Matrix<R,C>& b);
+    template <int R, int C, class T>
+    friend constexpr Matrix<R,C,T> operator-(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b);
     
     /**
      * Multiply the RL x CLRR Matrix a and the CLRR x CR Matrix b
@@ -319,9 +602,9 @@ class Matrix
      * @param b   The left Matrix
      * @return    The resulting Matrix
      */
-    template <int RL, int CLRR, int CR>
-    friend Matrix<RL,CR> operator*(const Matrix<RL,CLRR>& a, 
-                                   const Matrix<CLRR,CR>& b);
+    template <int RL, int CLRR, int CR, class T>
+    friend constexpr Matrix<RL,CR,T> operator*(const Matrix<RL,CLRR,T>& a, 
+                                   const Matrix<CLRR,CR,T>& b);
     
     /**
      * Multiply a scalar and an R x C Matrix
@@ -330,8 +613,8 @@ class Matrix
      * @param a   The Matrix
      * @return    The resulting Matrix
      */
-    template <int R, int C>
-    friend Matrix<R,C> operator*(double k, const Matrix<R,C>& a);
+    template <int R, int C, class T>
+    friend constexpr Matrix<R,C,T> operator*(typename MatrixScalar<T>::type k, const Matrix<R,C,T>& a);
     
     /**
      * Multiply an R x C Matrix and a scalar
@@ -340,8 +623,8 @@ class Matrix
      * @param k   The scalar
      * @return    The resulting Matrix
      */
-    template <int R, int C>
-    friend Matrix<R,C> operator*(const Matrix<R,C>& a, double k);
+    template <int R, int C, class T>
+    friend constexpr Matrix<R,C,T> operator*(const Matrix<R,C,T>& a, typename MatrixScalar<T>::type k);
     
     /**
      * Compare two R x C Matrix objects to see if they have identical 
@@ -351,8 +634,8 @@ class Matrix
      * @param b   The right matrix
      * @return    true or false
      */
-    template <int R, int C>
-    friend bool operator==(const Matrix<R,C>& a, const Matrix<R,C>& b);
+    template <int R, int C, class T>
+    friend constexpr bool operator==(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b);
     
     /**
      * Compare two R x C Matrix objects to see if they have different elements
@@ -362,22 +645,8 @@ class Matrix
      * @param b   The right matrix
      @return    true if any elements are different; false otherwise
      */
-    template <int R, int C>
-    friend bool operator!=(const Matrix<R,C>& a, const Matrix<R,C>& b);
-    
-    /**
-     * Remove a row and column from a 2x2 matrix
-     *
-     * Note: This is a function template so that it is 1:1 with the class
-     * (which avoid problems of duplicate definitions when linking)
-     *
-     * @param a   The Matrix
-     * @param i   The index of the row to exclude
-     * @param j   The index of the col to exclude
-     * @return    The resulting scalar
-     */
-    template <int R, int C>
-    friend double submatrix(const Matrix<2,2>& a, int i, int j);
+    template <int R, int C, class T>
+    friend constexpr bool operator!=(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b);
     
     /**
      * Remove a row and column from an R x C Matrix
@@ -389,8 +658,8 @@ class Matrix
      * @throws    out_of_range if i or j are out of bounds
      * @return    The submatrix (i.e., a with row i and column j excluded)
      */
-    template <int R, int C>
-    friend Matrix<R-1,C-1> submatrix(const Matrix<R,C>& a, int i, int j);
+    template <int R, int C, class T>
+    friend Matrix<R-1,C-1,T> submatrix(const Matrix<R,C,T>& a, int i, int j);
     
     /**
      * Create and return a transposed version of an R x C Matrix
@@ -398,8 +667,8 @@ class Matrix
      * @param a   The original Matrix
      * @return    The transpose of a
      */
-    template <int R, int C>
-    friend Matrix<C,R> trans(const Matrix<R,C>& a);
+    template <int R, int C, class T>
+    friend constexpr Matrix<C,R,T> trans(const Matrix<R,C,T>& a);
     
 };
 
@@ -411,11 +680,56 @@ class Matrix
 /**
  * Default Constructor
  */
-template <int R, int C>
-Matrix<R,C>::Matrix()
+template <int R, int C, class T>
+constexpr Matrix<R,C,T>::Matrix()
+   : values{}
 {
-   allocateMemory(R, C);   
-   setValues(0.0);
+   MATRIX_COUNT(constructed);
+}
+
+
+/**
+ * Construct a Matrix from a row-major array of values
+ *
+ * Note: Unlike operator=(initializer_list), this constructor can be
+ * used in constant expressions, which makes it possible to create
+ * Matrix objects at compile time. For example:
+ *
+ *   constexpr Matrix<2,4> XY({1,0,0,0,
+ *                             0,1,0,0});
+ *
+ * @param m   The values (in row-major order)
+ */
+template <int R, int C, class T>
+constexpr Matrix<R,C,T>::Matrix(const T (&m)[R*C])
+   : values{}
+{
+   MATRIX_COUNT(constructed);
+   setValues(m);
+}
+
+
+/**
+ * Construct an R x C Matrix from its elements (in row-major order).
+ *
+ * Example of use:
+ *
+ *   Matrix<2,2> m(1, 2,
+ *                 3, 4);
+ *
+ * Unlike assigning an initializer_list, the number of elements is
+ * checked at compile time, and the elements may be of any type that
+ * converts to T (e.g., the int coordinates of a pixel).
+ *
+ * @param args   The R*C elements
+ */
+template <int R, int C, class T>
+template <class... Args, class>
+constexpr Matrix<R,C,T>::Matrix(Args... args)
+   : values{}
+{
+   MATRIX_COUNT(constructed);
+   setElements(args...);
 }
 
 
@@ -428,44 +742,79 @@ Matrix<R,C>::Matrix()
  *
  * @param original  The Matrix to copy
  */
-template <int R, int C>
-Matrix<R,C>::Matrix(const Matrix<R,C>& original)
+template <int R, int C, class T>
+constexpr Matrix<R,C,T>::Matrix(const Matrix<R,C,T>& original)
+   : values{}
 {
-   allocateMemory(R, C);   
-   setValues(original.values);
+   MATRIX_COUNT(constructed);
+   MATRIX_COUNT(copied);
+   setValues(original);
 }
 
 
+/**
+ * Move constructor
+ *
+ * Note: Since the elements are stored inline there is nothing to
+ * steal from the original, so this is an element-wise copy. However,
+ * unlike the copy constructor, it can never throw, which lets
+ * containers (and return statements) move rather than copy.
+ *
+ * @param original  The Matrix to move
+ */
+template <int R, int C, class T>
+constexpr Matrix<R,C,T>::Matrix(Matrix<R,C,T>&& original) noexcept
+   : values{}
+{
+   MATRIX_COUNT(constructed);
+   setValues(original);
+}
 
- /**
-  * Destructor
-  */
-template <int R, int C>
-Matrix<R,C>::~Matrix()
+
+/**
+ * Construct a Matrix by converting the elements of a Matrix with a
+ * different element type
+ *
+ * Note: This constructor is explicit so that a change in precision
+ * (e.g., from double to float) is always visible. For example:
+ *
+ *   Matrix<4,3,float> vertices(triangle.vertices);
+ *
+ * @param original  The Matrix to convert
+ */
+template <int R, int C, class T>
+template <class U>
+constexpr Matrix<R,C,T>::Matrix(const Matrix<R,C,U>& original)
+   : values{}
 {
-   deallocateMemory();
+   MATRIX_COUNT(constructed);
+   for (int r=0; r<R; r++)
+   {
+      for (int c=0; c<C; c++)
+      {
+         this->values[r][c] = static_cast<T>(original.values[r][c]);
+      }
+   }
 }
 
 
 /**
- * Allocate memory for this Matrix
+ * Construct a Matrix by evaluating an expression
  *
- * @throw length error if either rows or columns is less than 0
+ * @param e   The expression
  */
-template <int R, int C>
-void Matrix<R,C>::allocateMemory(int rows, int columns)
-{
-    // Note: This method does not use R and C so that it can be called
-    // by non-templated methods and subclasses
-    if(rows <= 0 || columns <= 0)
-        throw std::length_error("constructor error");
-    this->values  = new double*[rows];
-    for (int r=0; r<rows; r++) this->values[r] = new double[columns];
+template <int R, int C, class T>
+template <class E>
+Matrix<R,C,T>::Matrix(const MatrixExpression<E,R,C>& e)
+{
+   MATRIX_COUNT(constructed);
+   // This is a new object, so e cannot refer to it
+   e.evalTo(*this);
 }
 
 
-template <int R, int C>
-void printMatrix(const Matrix<R,C>& a)
+template <int R, int C, class T>
+void printMatrix(const Matrix<R,C,T>& a)
 {
     for(int i = 0; i < R; ++i)
     {
@@ -486,85 +835,186 @@ void printMatrix(const Matrix<R,C>& a)
  * @throws    out_of_range if i or j are out of bounds
  * @return    The cofactor
  */
-template <int RC>
-double cof(const Matrix<RC,RC>& a, int i, int j)
+template <int RC, class T>
+T cof(const Matrix<RC,RC,T>& a, int i, int j)
 {
     if(RC-1 < i || RC-1 < j || 0 > i || 0 > j)
         throw std::out_of_range("Out of range");
 
-    double result = 0;
+    T result = T();
 
     result = matrix_minor(a, i, j);
     //return (j % 2 == 0) ? 1 : -1;
     return (j % 2 == 0) ? result : -1 * result;
 }
 
-/**
- * Deallocate the memory used by this Matrix
- */
-template <int R, int C>
-void Matrix<R,C>::deallocateMemory()
-{
-   for (int r=0; r<R; r++) delete[] this->values[r];
-   delete[] this->values;
-}
-
-
 /**
  * Calculate the determinant of a scalar (which is useful when
  * calculating the determinant of a matrix using cofactors)
  *
- * Note: This is a function template so that it is 1:1 with the class
- * (which avoid problems of duplicate definitions when linking)
+ * Note: This function is inline to avoid problems of duplicate
+ * definitions when linking
  *
  * @param a   The value of the scalar
  * @return    The determinant of a (which is just a)
  */
-template <int R, int C>
-double det(double a)
+inline double det(double a)
 {
    return a;
 }
 
 
 /**
- * Calculate the determinant of an RC x RC matrix
- *
- * Note: This implementation is not efficient since it
- * explicitly creates each of the minors. However, it is easy to understand.
+ * The kernel that calculates the determinant of an RC x RC Matrix
  *
- * @param a   The matrix (which must be square)
- * @throws    length_error if the Matrix is smaller than 2x2
- * @return    The value of the determinant
+ * Note: This is a class (rather than a function) template so that it
+ * can be specialized for particular sizes. The general version uses
+ * fraction-free (Bareiss) elimination with partial pivoting, which takes
+ * O(RC^3) operations and no allocations. Every intermediate value is a
+ * minor of the Matrix (and every division is exact), so, like the
+ * cofactor expansion, it is exact for a Matrix of (not too large)
+ * integers (e.g., it is exactly 0 for a singular one). 2x2, 3x3, and
+ * 4x4 matrices use closed-form expressions (which read the elements
+ * directly, so they also work for views, see MatrixView.hpp).
  */
-template <int RC>
-double det(const Matrix<RC,RC>& a)
+template <int RC, class T>
+struct MatrixDeterminant
 {
-    if(RC < 2)
-        throw std::length_error("too small size of matrix");
+    template <class E>
+    static T compute(const MatrixExpression<E,RC,RC>& a)
+    {
+        Matrix<RC,RC,T> m(a.derived());
+        T               sign = T(1), previous = T(1);
+
+        for(int k = 0; k < RC - 1; ++k)
+        {
+            // Find the pivot
+            int p = k;
+            for(int r = k + 1; r < RC; ++r)
+            {
+                if(magnitude(m(r,k)) > magnitude(m(p,k))) p = r;
+            }
+            if(m(p,k) == T()) return T();
+
+            if(p != k)
+            {
+                for(int c = k; c < RC; ++c)
+                {
+                    T temp = m(k,c);
+                    m(k,c) = m(p,c);
+                    m(p,c) = temp;
+                }
+                sign = -sign;
+            }
+
+            // Replace the rest of the Matrix with 2x2 minors (divided by
+            // the previous pivot)
+            for(int r = k + 1; r < RC; ++r)
+                for(int c = k + 1; c < RC; ++c)
+                    m(r,c) = (m(r,c) * m(k,k) - m(r,k) * m(k,c)) / previous;
+            previous = m(k,k);
+        }
 
-    double result = 0;
+        return sign * m(RC-1,RC-1);
+    }
 
-    if(RC == 1)
+  private:
+    static T magnitude(const T& x)
     {
-        result = a.values[0][0];
+        return (x < T()) ? -x : x;
     }
-    else if(RC == 2)
+};
+
+template <class T>
+struct MatrixDeterminant<1,T>
+{
+    template <class E>
+    static T compute(const MatrixExpression<E,1,1>& a)
     {
-        result = a.values[0][0] * a.values[1][1] 
-            - a.values[0][1] * a.values[1][0];
+        throw std::length_error("too small size of matrix");
     }
-    else
+};
+
+template <class T>
+struct MatrixDeterminant<2,T>
+{
+    template <class E>
+    static constexpr T compute(const MatrixExpression<E,2,2>& a)
     {
-        for(int r = 0; r < RC; ++r)
-            result +=  cof(a, 0, r) * a.values[0][r];
+        return a.element(0,0) * a.element(1,1) 
+            - a.element(0,1) * a.element(1,0);
     }
+};
+
+template <class T>
+struct MatrixDeterminant<3,T>
+{
+    template <class E>
+    static constexpr T compute(const MatrixExpression<E,3,3>& a)
+    {
+        auto m = [&a](int r, int c) { return a.element(r, c); };
 
-    //recursively find determinant of minor
-    //    result += cof(a, 0, r) * a.values[0][r];
-    //}
+        // Expand along row 0
+        return m(0,0) * (m(1,1)*m(2,2) - m(1,2)*m(2,1))
+             - m(0,1) * (m(1,0)*m(2,2) - m(1,2)*m(2,0))
+             + m(0,2) * (m(1,0)*m(2,1) - m(1,1)*m(2,0));
+    }
+};
 
-    return result;
+template <class T>
+struct MatrixDeterminant<4,T>
+{
+    template <class E>
+    static constexpr T compute(const MatrixExpression<E,4,4>& a)
+    {
+        auto m = [&a](int r, int c) { return a.element(r, c); };
+
+        // The 2x2 minors of rows 0 and 1 and of rows 2 and 3
+        // (i.e., Laplace expansion along the first two rows)
+        T s0 = m(0,0)*m(1,1) - m(1,0)*m(0,1);
+        T s1 = m(0,0)*m(1,2) - m(1,0)*m(0,2);
+        T s2 = m(0,0)*m(1,3) - m(1,0)*m(0,3);
+        T s3 = m(0,1)*m(1,2) - m(1,1)*m(0,2);
+        T s4 = m(0,1)*m(1,3) - m(1,1)*m(0,3);
+        T s5 = m(0,2)*m(1,3) - m(1,2)*m(0,3);
+
+        T c5 = m(2,2)*m(3,3) - m(3,2)*m(2,3);
+        T c4 = m(2,1)*m(3,3) - m(3,1)*m(2,3);
+        T c3 = m(2,1)*m(3,2) - m(3,1)*m(2,2);
+        T c2 = m(2,0)*m(3,3) - m(3,0)*m(2,3);
+        T c1 = m(2,0)*m(3,2) - m(3,0)*m(2,2);
+        T c0 = m(2,0)*m(3,1) - m(3,0)*m(2,1);
+
+        return s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+    }
+};
+
+
+/**
+ * Calculate the determinant of an RC x RC matrix
+ *
+ * @param a   The matrix (which must be square)
+ * @throws    length_error if the Matrix is smaller than 2x2
+ * @return    The value of the determinant
+ */
+template <int RC, class T>
+constexpr T det(const Matrix<RC,RC,T>& a)
+{
+    return MatrixDeterminant<RC,T>::compute(a);
+}
+
+
+/**
+ * Calculate the determinant of an RC x RC expression (e.g., a view)
+ *
+ * @param a   The expression (which must be square)
+ * @throws    length_error if the expression is smaller than 2x2
+ * @return    The value of the determinant
+ */
+template <class E, int RC>
+constexpr typename E::Scalar det(const MatrixExpression<E,RC,RC>& a)
+{
+    return MatrixDeterminant<RC,typename E::Scalar>::compute(a);
 }
 
 
@@ -583,11 +1033,11 @@ double det(const Matrix<RC,RC>& a)
  * @param b  The right Matrix
  * @return   The scalar product
  */
-template<int R, int C>
-double dot(const Matrix<R,C>& a, const Matrix<R,C>& b)
+template <int R, int C, class T>
+constexpr T dot(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b)
 {
    int r,c;
-   double ret = 0;
+   T ret = T();
    for(r = 0; r < R; ++r)
    {
        for(c = 0; c < C; ++c)
@@ -600,6 +1050,30 @@ double dot(const Matrix<R,C>& a, const Matrix<R,C>& b)
 }
 
 
+/**
+ * Calculate the dot product of two R x C expressions (e.g., views)
+ *
+ * @param a  The left expression
+ * @param b  The right expression
+ * @return   The scalar product
+ */
+template <class L, class Rt, int R, int C>
+constexpr typename L::Scalar dot(const MatrixExpression<L,R,C>& a,
+                                 const MatrixExpression<Rt,R,C>& b)
+{
+   typename L::Scalar ret = typename L::Scalar();
+   for(int r = 0; r < R; ++r)
+   {
+       for(int c = 0; c < C; ++c)
+       {
+           ret += a.element(r,c) * b.element(r,c);
+       }
+   }
+
+   return ret;
+}
+
+
 /**
  * Get a particular element of this R x C Matrix.
  *
@@ -608,8 +1082,8 @@ double dot(const Matrix<R,C>& a, const Matrix<R,C>& b)
  * @throws    out_of_range if r or c are out of bounds
  * @return    The value of the element
  */
-template <int R, int C>
-double Matrix<R,C>::get(int r, int c) const
+template <int R, int C, class T>
+constexpr T Matrix<R,C,T>::get(int r, int c) const
 {
     if(R-1 < r || C-1 < c || 0 > c || 0 > r)
         throw std::out_of_range("get(int,int): out of range");
@@ -626,8 +1100,8 @@ double Matrix<R,C>::get(int r, int c) const
  * @throws    length_error if this is neither a single row nor single column
  * @return    The value of the element
  */
-template <int R, int C>
-double Matrix<R,C>::get(int i) const
+template <int R, int C, class T>
+constexpr T Matrix<R,C,T>::get(int i) const
 {
     if(R != 1 && C != 1)
         throw std::length_error("get(int): length error, Not a vector");
@@ -637,23 +1111,141 @@ double Matrix<R,C>::get(int i) const
     return (R == 1) ? this->values[0][i] : this->values[i][0];
 }
 
+/**
+ * Get a particular element of this R x C Matrix, where the indexes
+ * are known at compile time
+ *
+ * @param r   The row index
+ * @param c   The column index
+ * @return    The value of the element
+ */
+template <int R, int C, class T>
+template <int r, int c>
+constexpr T Matrix<R,C,T>::get() const
+{
+    static_assert(0 <= r && r < R && 0 <= c && c < C, "get<r,c>(): out of range");
+    return this->values[r][c];
+}
+
+
+/**
+ * Access a particular element of this R x C Matrix, where the indexes
+ * are known at compile time
+ *
+ * @param r   The row index
+ * @param c   The column index
+ * @return    The element
+ */
+template <int R, int C, class T>
+template <int r, int c>
+constexpr T& Matrix<R,C,T>::get()
+{
+    static_assert(0 <= r && r < R && 0 <= c && c < C, "get<r,c>(): out of range");
+    return this->values[r][c];
+}
+
+
+/**
+ * Get a particular element of this Matrix if it contains a single row
+ * or single column, where the index is known at compile time
+ *
+ * @param i   The index
+ * @return    The value of the element
+ */
+template <int R, int C, class T>
+template <int i>
+constexpr T Matrix<R,C,T>::get() const
+{
+    static_assert(R == 1 || C == 1, "get<i>(): Not a vector");
+    static_assert(0 <= i && i < R*C, "get<i>(): out of range");
+    if constexpr (R == 1) return this->values[0][i];
+    else                  return this->values[i][0];
+}
+
+
+/**
+ * Get a pointer to the (contiguous, row-major) elements of this
+ * R x C Matrix
+ *
+ * @return    A pointer to the element in row 0 and column 0
+ */
+template <int R, int C, class T>
+constexpr const T* Matrix<R,C,T>::data() const
+{
+    return &this->values[0][0];
+}
+
+template <int R, int C, class T>
+constexpr T* Matrix<R,C,T>::data()
+{
+    return &this->values[0][0];
+}
+
+
+/**
+ * Get a pointer to a row of this R x C Matrix
+ *
+ * @param r   The row index
+ * @throws    out_of_range if r is out of bounds (only if
+ *            MATRIX_RANGE_CHECKS is defined)
+ * @return    A pointer to the first element of the row
+ */
+template <int R, int C, class T>
+constexpr const T* Matrix<R,C,T>::rowPointer(int r) const
+{
+    MATRIX_CHECK_RANGE(0 <= r && r < R, "rowPointer(int): out of range");
+    return this->values[r];
+}
+
+template <int R, int C, class T>
+constexpr T* Matrix<R,C,T>::rowPointer(int r)
+{
+    MATRIX_CHECK_RANGE(0 <= r && r < R, "rowPointer(int): out of range");
+    return this->values[r];
+}
+
+
+/**
+ * Get a pointer to a column of this R x C Matrix (whose elements are
+ * C elements apart)
+ *
+ * @param c   The column index
+ * @throws    out_of_range if c is out of bounds (only if
+ *            MATRIX_RANGE_CHECKS is defined)
+ * @return    A pointer to the first element of the column
+ */
+template <int R, int C, class T>
+constexpr const T* Matrix<R,C,T>::columnPointer(int c) const
+{
+    MATRIX_CHECK_RANGE(0 <= c && c < C, "columnPointer(int): out of range");
+    return &this->values[0][c];
+}
+
+template <int R, int C, class T>
+constexpr T* Matrix<R,C,T>::columnPointer(int c)
+{
+    MATRIX_CHECK_RANGE(0 <= c && c < C, "columnPointer(int): out of range");
+    return &this->values[0][c];
+}
+
+
 /**
  * Get an R x 1 column of this R x C Matrix
  *
  * Note: This is not an efficient method, and it would be much better
  * to use rows rather than columns (since we are using row-major ordering).
  * However, this is more consistent with the mathematical treatment
- * in most books.
+ * in most books. (columnView() doesn't copy the column.)
  *
  * @param c   The index of the column (0-based)
  */
-template <int R, int C>
-Matrix<R,1> Matrix<R,C>::getColumn(int c) const
+template <int R, int C, class T>
+constexpr Matrix<R,1,T> Matrix<R,C,T>::getColumn(int c) const
 {
     if(c > C)
         throw std::out_of_range("GetColumn: out of range\n");
 
-    Matrix<R, 1> retMatrix;
+    Matrix<R, 1, T> retMatrix;
     for(int r = 0; r < R; ++r)
     {
         retMatrix(r,0) = this->values[r][c];
@@ -662,13 +1254,82 @@ Matrix<R,1> Matrix<R,C>::getColumn(int c) const
 }
 
 
+/**
+ * Get a (zero-copy) view of a column of this R x C Matrix
+ *
+ * @param c   The index of the column (0-based)
+ * @throws    out_of_range if c is out of bounds
+ * @return    The view
+ */
+template <int R, int C, class T>
+constexpr MatrixView<R,1,T> Matrix<R,C,T>::columnView(int c) const
+{
+    if(C-1 < c || 0 > c)
+        throw std::out_of_range("columnView(int): out of range");
+
+    return MatrixView<R,1,T>(&this->values[0][c], C, 1, this);
+}
+
+
+/**
+ * Get a (zero-copy) view of a row of this R x C Matrix
+ *
+ * @param r   The index of the row (0-based)
+ * @throws    out_of_range if r is out of bounds
+ * @return    The view
+ */
+template <int R, int C, class T>
+constexpr MatrixView<1,C,T> Matrix<R,C,T>::rowView(int r) const
+{
+    if(R-1 < r || 0 > r)
+        throw std::out_of_range("rowView(int): out of range");
+
+    return MatrixView<1,C,T>(this->values[r], C, 1, this);
+}
+
+
+/**
+ * Get a (zero-copy) view of a BR x BC block of this R x C Matrix
+ *
+ * @param r   The index of the first row of the block
+ * @param c   The index of the first column of the block
+ * @throws    out_of_range if the block is out of bounds
+ * @return    The view
+ */
+template <int R, int C, class T>
+template <int BR, int BC>
+constexpr MatrixView<BR,BC,T> Matrix<R,C,T>::blockView(int r, int c) const
+{
+    static_assert(BR <= R && BC <= C, "blockView<R,C>(): block is too large");
+    if(R-BR < r || C-BC < c || 0 > r || 0 > c)
+        throw std::out_of_range("blockView(int,int): out of range");
+
+    return MatrixView<BR,BC,T>(&this->values[r][c], C, 1, this);
+}
+
+
+/**
+ * Get a (zero-copy) view of the transpose of an R x C Matrix
+ *
+ * Note: Unlike trans(), this doesn't create a new Matrix.
+ *
+ * @param a   The Matrix
+ * @return    The view
+ */
+template <int R, int C, class T>
+constexpr MatrixView<C,R,T> transView(const Matrix<R,C,T>& a)
+{
+    return MatrixView<C,R,T>(a.data(), 1, C, &a);
+}
+
+
 /**
  * Get the number of columns in this R x C Matrix
  *
  * @return  The number of columns (i.e., C)
  */
-template <int R, int C>
-int Matrix<R,C>::getColumns() const
+template <int R, int C, class T>
+constexpr int Matrix<R,C,T>::getColumns() const
 {
    return C;   
 }
@@ -679,8 +1340,8 @@ int Matrix<R,C>::getColumns() const
  *
  * @return  The number of rows (i.e., R)
  */
-template <int R, int C>
-int Matrix<R,C>::getRows() const
+template <int R, int C, class T>
+constexpr int Matrix<R,C,T>::getRows() const
 {
    return R;   
 }
@@ -694,13 +1355,13 @@ int Matrix<R,C>::getRows() const
  *
  * @return        An identity Matrix
  */
-template <int RC>
-Matrix<RC,RC> identity()
+template <int RC, class T>
+constexpr Matrix<RC,RC,T> identity()
 {
-    Matrix<RC, RC> idn;
+    Matrix<RC, RC, T> idn;
     for(int i = 0; i < RC; ++i)
     {
-        idn.values[i][i] = 1.0;
+        idn.values[i][i] = T(1);
     }
 
     return idn;
@@ -717,10 +1378,12 @@ Matrix<RC,RC> identity()
  * @param j   The index of the column to exclude
  * @return    The minor
  */
-template <int RC>
-double matrix_minor(const Matrix<RC,RC>& a, int i, int j)
+template <int RC, class T>
+T matrix_minor(const Matrix<RC,RC,T>& a, int i, int j)
 {
-     return det(submatrix(a, i, j));
+     // (The submatrix of a 2x2 Matrix is a scalar)
+     if constexpr (RC == 2) return submatrix(a, i, j);
+     else                   return det(submatrix(a, i, j));
 }
 
 /*
@@ -749,8 +1412,8 @@ double matrix_minor<2>(const Matrix<2,2>& a, int i, int j)
  * @throws    out_of_range if r or c are out of bounds
  * @return    The value of the element
   */
-template <int R, int C>
-double& Matrix<R,C>::operator()(int r, int c)
+template <int R, int C, class T>
+constexpr T& Matrix<R,C,T>::operator()(int r, int c)
 {
     if(R-1 < r || C-1 < c || 0 > r || 0 > c)
         throw std::out_of_range("operator(int,int): out of range");
@@ -768,8 +1431,8 @@ double& Matrix<R,C>::operator()(int r, int c)
  * @throws    length_error if this is neither a single row nor single column
  * @return    The the element
  */
-template <int R, int C>
-double& Matrix<R,C>::operator()(int i)
+template <int R, int C, class T>
+constexpr T& Matrix<R,C,T>::operator()(int i)
 {
     if(R != 1 && C != 1)
         throw std::length_error("operator(int): length error");
@@ -797,20 +1460,44 @@ double& Matrix<R,C>::operator()(int i)
  * @param m   The initializer_list containing the values
  * @return    The Matrix referred to by this
  */
-template <int R, int C>
-Matrix<R,C>& Matrix<R,C>::operator=(std::initializer_list<double> m)
+template <int R, int C, class T>
+Matrix<R,C,T>& Matrix<R,C,T>::operator=(std::initializer_list<T> m)
 {
     //if length of list is not matched to matrix size
-    //will throw exception or static_assert for compile time error
+    //will throw exception (use assign() for a compile time check)
     if(m.size() != R*C)
         throw std::length_error("operator=: size is different");
     
-    const double * value = m.begin();
+    const T * value = m.begin();
     this->setValues(value);
     
     return *this; 
 }
 
+/**
+ * Assign R*C elements (in row-major order) to this R x C Matrix.
+ *
+ * Example of use:
+ *
+ *   testPoint.assign(x, y);
+ *
+ * This is the compile time checked version of operator= with an
+ * initializer_list (there is no list to build or to traverse).
+ *
+ * @param args   The R*C elements
+ * @return       The Matrix referred to by this
+ */
+template <int R, int C, class T>
+template <class... Args>
+constexpr Matrix<R,C,T>& Matrix<R,C,T>::assign(Args... args)
+{
+    static_assert(MatrixElements<T,Args...>::value,
+                  "assign: the elements must be convertible to T");
+    this->setElements(args...);
+
+    return *this;
+}
+
 /**
  * Assign another R x C Matrix to this R x C Matrix
  *
@@ -822,14 +1509,54 @@ Matrix<R,C>& Matrix<R,C>::operator=(std::initializer_list<double> m)
  * @param other   The Matrix to copy
  * @return        The Matrix referred to by this
  */
-template <int R, int C>
-Matrix<R,C>& Matrix<R,C>::operator=(const Matrix<R,C>& other)
+template <int R, int C, class T>
+constexpr Matrix<R,C,T>& Matrix<R,C,T>::operator=(const Matrix<R,C,T>& other)
+{
+    this->setValues(other);
+    return *this;
+}
+
+
+/**
+ * Move another R x C Matrix into this R x C Matrix
+ *
+ * @param other   The Matrix to move
+ * @return        The Matrix referred to by this
+ */
+template <int R, int C, class T>
+constexpr Matrix<R,C,T>& Matrix<R,C,T>::operator=(Matrix<R,C,T>&& other) noexcept
 {
     this->setValues(other);
     return *this;
 }
 
 
+/**
+ * Evaluate an expression into this R x C Matrix
+ *
+ * Note: If this Matrix is one of the operands of the expression (e.g.,
+ * a = lazy(a) * b) the expression is evaluated into a temporary first.
+ *
+ * @param e   The expression
+ * @return    The Matrix referred to by this
+ */
+template <int R, int C, class T>
+template <class E>
+Matrix<R,C,T>& Matrix<R,C,T>::operator=(const MatrixExpression<E,R,C>& e)
+{
+    if(e.aliases(this))
+    {
+        Matrix<R,C,T> temp(e);
+        this->setValues(temp);
+    }
+    else
+    {
+        e.evalTo(*this);
+    }
+    return *this;
+}
+
+
 /**
  * Concatenate the columns of the RLR x CL Matrix a and the 
  * columns of the RLR x CR Matrix b to create a
@@ -842,11 +1569,11 @@ Matrix<R,C>& Matrix<R,C>::operator=(const Matrix<R,C>& other)
  * @param b   The right Matrix
  * @return    a concatenated with b
  */
-template <int RLR, int CL, int CR>
-Matrix<RLR,CL+CR> operator|(const Matrix<RLR,CL>& a, 
-                            const Matrix<RLR,CR>& b)
+template <int RLR, int CL, int CR, class T>
+constexpr Matrix<RLR,CL+CR,T> operator|(const Matrix<RLR,CL,T>& a, 
+                            const Matrix<RLR,CR,T>& b)
 {
-    Matrix<RLR, CL+CR> retMatrix;
+    Matrix<RLR, CL+CR, T> retMatrix;
     int acol = 0, bcol = 0;
     for(int i = 0; i < RLR; ++i)
     {
@@ -873,10 +1600,10 @@ Matrix<RLR,CL+CR> operator|(const Matrix<RLR,CL>& a,
  * @param b   The right Matrix
  * @return    a+b
  */
-template <int R, int C>
-Matrix<R,C> operator+(const Matrix<R,C>& a, const Matrix<R,C>& b)
+template <int R, int C, class T>
+constexpr Matrix<R,C,T> operator+(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b)
 {
-    Matrix<R,C> result;
+    Matrix<R,C,T> result;
 
     int r,c;
     for(r = 0; r < R; ++r)
@@ -900,10 +1627,10 @@ Matrix<R,C> operator+(const Matrix<R,C>& a, const Matrix<R,C>& b)
  * @param b   The right Matrix
  * @return    a-b
  */
-template <int R, int C>
-Matrix<R,C> operator-(const Matrix<R,C>& a, const Matrix<R,C>& b)
+template <int R, int C, class T>
+constexpr Matrix<R,C,T> operator-(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b)
 {
-    Matrix<R,C> result;
+    Matrix<R,C,T> result;
 
     for(int r = 0; r < R; ++r)
     {
@@ -914,6 +1641,54 @@ Matrix<R,C> operator-(const Matrix<R,C>& a, const Matrix<R,C>& b)
     return result;
 }
 
+/**
+ * The generic (scalar) kernel that multiplies an RL x CLRR Matrix and
+ * a CLRR x CR Matrix (which, unlike the specialized kernels, can be
+ * evaluated at compile time)
+ */
+template <int RL, int CLRR, int CR, class T>
+struct GenericMatrixMultiply
+{
+    /**
+     * Multiply the RL x CLRR Matrix a and the CLRR x CR Matrix b
+     *
+     * @param a       The left Matrix
+     * @param b       The right Matrix
+     * @param result  The product (which must be neither a nor b)
+     */
+    static constexpr void multiply(const Matrix<RL,CLRR,T>& a,
+                                   const Matrix<CLRR,CR,T>& b,
+                                   Matrix<RL,CR,T>& result)
+    {
+        T dotResult = T();
+        //take row of a and multiply with col of b
+        for(int r = 0; r < RL; ++r)
+        {
+            for(int c = 0; c < CR; ++c)
+            {
+                for(int index = 0; index < CLRR; ++index)
+                    dotResult += a.values[r][index] * b.values[index][c];
+                result.values[r][c] = dotResult;
+                dotResult = 0.0; //reset product result for next position
+            }
+        }
+    }
+};
+
+
+/**
+ * The kernel that multiplies an RL x CLRR Matrix and a CLRR x CR Matrix
+ *
+ * Note: This is a class (rather than a function) template so that it
+ * can be (partially) specialized for particular sizes. The specialized
+ * (SIMD) versions are in MatrixKernels.hpp.
+ */
+template <int RL, int CLRR, int CR, class T>
+struct MatrixMultiply: public GenericMatrixMultiply<RL,CLRR,CR,T>
+{
+};
+
+
 /**
  * Multiply the RL x CLRR Matrix a and the CLRR x CR Matrix b
  * to create a RL CR Matrix
@@ -925,23 +1700,16 @@ Matrix<R,C> operator-(const Matrix<R,C>& a, const Matrix<R,C>& b)
  * @param b   The right Matrix
  * @return    The resulting Matrix
  */
-template <int RL, int CLRR, int CR>
-Matrix<RL,CR> operator*(const Matrix<RL,CLRR>& a, const Matrix<CLRR,CR>& b)
+template <int RL, int CLRR, int CR, class T>
+constexpr Matrix<RL,CR,T> operator*(const Matrix<RL,CLRR,T>& a, const Matrix<CLRR,CR,T>& b)
 {
-    Matrix<RL,CR> result;
-    
-    double dotResult = 0.0;
-    //take row of a and multiply with col of b
-    for(int r = 0; r < RL; ++r)
-    {
-        for(int c = 0; c < CR; ++c)
-        {
-            for(int index = 0; index < CLRR; ++index)
-                dotResult += a.values[r][index] * b.values[index][c];
-            result.values[r][c] = dotResult;
-            dotResult = 0.0; //reset product result for next position
-        }
-    }
+    Matrix<RL,CR,T> result;
+
+    // The specialized (SIMD) kernels can't be evaluated at compile time
+    if (MATRIX_IS_CONSTANT_EVALUATED())
+        GenericMatrixMultiply<RL,CLRR,CR,T>::multiply(a, b, result);
+    else
+        MatrixMultiply<RL,CLRR,CR,T>::multiply(a, b, result);
     return result;
 }
 
@@ -956,10 +1724,10 @@ Matrix<RL,CR> operator*(const Matrix<RL,CLRR>& a, const Matrix<CLRR,CR>& b)
  * @param a   The Matrix
  * @return    The resulting Matrix
  */
-template <int R, int C>
-Matrix<R,C> operator*(double k, const Matrix<R,C>& a)
+template <int R, int C, class T>
+constexpr Matrix<R,C,T> operator*(typename MatrixScalar<T>::type k, const Matrix<R,C,T>& a)
 {
-    Matrix<R,C> result;
+    Matrix<R,C,T> result;
 
     for(int r = 0; r < R; ++r)
     {
@@ -981,8 +1749,8 @@ Matrix<R,C> operator*(double k, const Matrix<R,C>& a)
  * @param k   The scalar
  * @return    The resulting Matrix
  */
-template <int R, int C>
-Matrix<R,C> operator*(const Matrix<R,C>& a, double k)
+template <int R, int C, class T>
+constexpr Matrix<R,C,T> operator*(const Matrix<R,C,T>& a, typename MatrixScalar<T>::type k)
 {
    return k*a; // Use the other version
 }
@@ -996,14 +1764,19 @@ Matrix<R,C> operator*(const Matrix<R,C>& a, double k)
  * @param b   The right matrix
  * @return    true or false
  */
-template <int R, int C>
-bool operator==(const Matrix<R,C>& a, const Matrix<R,C>& b)
+template <int R, int C, class T>
+constexpr bool operator==(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b)
 {
+    // (which is 0 for integer element types, so they must be identical)
+    const T tolerance = static_cast<T>(TOLERANCE);
+
     for(int r = 0; r < R; ++r)
     {
         for(int c = 0; c < C; ++c)
         {
-            if(abs(a.values[r][c] - b.values[r][c]) > TOLERANCE)
+            // (abs() can't be evaluated at compile time)
+            T difference = a.values[r][c] - b.values[r][c];
+            if(difference > tolerance || -difference > tolerance)
                 return false;
         }
     }
@@ -1018,20 +1791,49 @@ bool operator==(const Matrix<R,C>& a, const Matrix<R,C>& b)
  * @param b   The right matrix
  * @return    true if any elements are different; false otherwise
  */
-template <int R, int C>
-bool operator!=(const Matrix<R,C>& a, const Matrix<R,C>& b)
+template <int R, int C, class T>
+constexpr bool operator!=(const Matrix<R,C,T>& a, const Matrix<R,C,T>& b)
 {
    return !(a == b);
 }
 
 
+/**
+ * Get a particular element of this R x C Matrix without checking the
+ * indexes (for use by expressions)
+ *
+ * @param r   The row index
+ * @param c   The column index
+ * @return    The value of the element
+ */
+template <int R, int C, class T>
+constexpr T Matrix<R,C,T>::coeff(int r, int c) const
+{
+   return this->values[r][c];
+}
+
+
+/**
+ * Determine whether this R x C Matrix is the given object (for use
+ * by expressions)
+ *
+ * @param m   The address of the object
+ * @return    true if this is m; false otherwise
+ */
+template <int R, int C, class T>
+bool Matrix<R,C,T>::refersTo(const void* m) const
+{
+   return this == m;
+}
+
+
 /**
  * Set the value of all elements in this Matrix to the given value
  *
  * @param value  The value to assign to every element
  */
-template <int R, int C>
-void Matrix<R,C>::setValues(double value)
+template <int R, int C, class T>
+constexpr void Matrix<R,C,T>::setValues(T value)
 {
    for (int r=0; r<R; r++)
    {
@@ -1048,11 +1850,19 @@ void Matrix<R,C>::setValues(double value)
  *
  * @param other   The other Matrix
  */
-template <int R, int C>
-void Matrix<R,C>::setValues(const Matrix<R,C>& other)
+template <int R, int C, class T>
+constexpr void Matrix<R,C,T>::setValues(const Matrix<R,C,T>& other)
 {
    // Don't self-assign! (Note: this is a reference; other is an object)
-   if (this != &other) setValues(other.values);
+   if (this == &other) return;
+
+   for (int r=0; r<R; r++)
+   {
+      for (int c=0; c<C; c++)
+      {
+         this->values[r][c] = other.values[r][c];
+      }
+   }
 }
 
 
@@ -1062,8 +1872,8 @@ void Matrix<R,C>::setValues(const Matrix<R,C>& other)
  *
  * @param values  A pointer to the row-major array
  */
-template <int R, int C>
-void Matrix<R,C>::setValues(const double* values)
+template <int R, int C, class T>
+constexpr void Matrix<R,C,T>::setValues(const T* values)
 {
    for (int r=0; r<R; r++)
    {
@@ -1073,38 +1883,33 @@ void Matrix<R,C>::setValues(const double* values)
       }
    }
 }
-   
+
 /**
- * Set the value of each element in this Matrix to the value of the
- * corresponding element in a "two-dimensional" array
+ * Set the elements of this Matrix (in row-major order) from a pack
  *
- * @param values  A pointer to the "two-dimensional" array
+ * @param args   The R*C elements
  */
-template <int R, int C>
-void Matrix<R,C>::setValues(double** values)
+template <int R, int C, class T>
+template <class... Args>
+constexpr void Matrix<R,C,T>::setElements(Args... args)
 {
-    for(int r = 0; r < R; r++)
-    {
-        for(int c = 0; c < C; c++)
-        {
-            this->values[r][c] = values[r][c];
-        }
-    }
+   static_assert(sizeof...(Args) == R*C,
+                 "the number of elements must be R*C");
+
+   int i = 0;
+   ((this->values[i / C][i % C] = static_cast<T>(args), ++i), ...);
 }
 
 /**
  * Remove a row and column from a 2x2 matrix
  *
- * Note: This is a function template so that it is 1:1 with the class
- * (which avoid problems of duplicate definitions when linking)
- *
  * @param a   The Matrix
  * @param i   The index of the row to exclude
  * @param j   The index of the col to exclude
  * @return    The resulting scalar
  */
-template <int R, int C>
-double submatrix(const Matrix<2,2>& a, int i, int j)
+template <class T>
+T submatrix(const Matrix<2,2,T>& a, int i, int j)
 {
    int col, row;
    if (i == 0) row = 1;
@@ -1113,7 +1918,7 @@ double submatrix(const Matrix<2,2>& a, int i, int j)
    if (j == 0) col = 1;
    else        col = 0;   
 
-   return a.values[row][col];   
+   return a.get(row, col);   
 }
 
 /**
@@ -1126,10 +1931,10 @@ double submatrix(const Matrix<2,2>& a, int i, int j)
  * @throws    out_of_range if i or j are out of bounds
  * @return    The submatrix (i.e., a with row i and column j excluded)
  */
-template <int R, int C>
-Matrix<R-1,C-1> submatrix(const Matrix<R,C>& a, int i, int j)
+template <int R, int C, class T>
+Matrix<R-1,C-1,T> submatrix(const Matrix<R,C,T>& a, int i, int j)
 {  
-    Matrix<R-1,C-1> result;
+    Matrix<R-1,C-1,T> result;
   
     int sr = 0, sc = 0;
     for(int r = 0; r < R; ++r)
@@ -1156,10 +1961,10 @@ Matrix<R-1,C-1> submatrix(const Matrix<R,C>& a, int i, int j)
  * @param a   The original Matrix
  * @return    The transpose of a
  */
-template <int R, int C>
-Matrix<C,R> trans(const Matrix<R,C>& a)
+template <int R, int C, class T>
+constexpr Matrix<C,R,T> trans(const Matrix<R,C,T>& a)
 {
-    Matrix<C,R> result;
+    Matrix<C,R,T> result;
 
     for(int c = 0; c < C; ++c)
     {
@@ -1173,4 +1978,7 @@ Matrix<C,R> trans(const Matrix<R,C>& a)
 }
 
 
+#include "MatrixKernels.hpp"
+#include "LUDecomposition.hpp"
+
 #endif
@@ -0,0 +1,388 @@
+/**
+ * Matrix expression templates
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __cs_matrix_expression_hpp__
+#define __cs_matrix_expression_hpp__
+
+#include <type_traits>
+
+/**
+ * The expression-template layer of Matrix.
+ *
+ * The operators in Matrix.hpp (e.g., a+b, a*b) are eager; each one
+ * returns a new Matrix. The operators in this file are lazy; each one
+ * returns a small object that records the operation and its operands,
+ * and the whole expression is evaluated (in one pass) when it is
+ * assigned to a Matrix.
+ *
+ * The lazy operators are selected as soon as one operand is an
+ * expression rather than a Matrix. The easiest way to start an
+ * expression is lazy():
+ *
+ *     view = lazy(p) * t * rx * ry;
+ *     c    = lazy(a) + b - 2.0 * d;
+ *
+ * Note: Element-wise expressions are fused into one loop over the
+ * destination. The operands of a product are evaluated first (into
+ * Matrix objects that live on the stack) since each of their elements
+ * is used more than once (except for views, see MatrixView.hpp, which
+ * are read directly).
+ *
+ * Note: An expression refers to its Matrix operands, so it must be
+ * evaluated in the statement that creates it (i.e., it should not be
+ * stored in an auto variable).
+ */
+
+// Prototype of the Matrix class
+// (so that it can be used in the expression classes)
+//
+// Note: This is the first declaration of Matrix, so it specifies the
+// default element type
+template <int R, int C, class T = double> class Matrix;
+
+template <int RL, int CLRR, int CR, class T> struct MatrixMultiply;
+
+
+/**
+ * The base class of everything that can appear in a Matrix expression
+ * (including Matrix itself)
+ *
+ * The parameter E is the class that is derived from this one (i.e.,
+ * the curiously recurring template pattern), and R and C are the
+ * number of rows and columns of the result. Every derived class
+ * defines Scalar (i.e., the element type of the result).
+ */
+template <class E, int R, int C>
+class MatrixExpression
+{
+  public:
+    /**
+     * Get the derived expression
+     *
+     * @return   The derived expression
+     */
+    constexpr const E& derived() const
+    {
+        return static_cast<const E&>(*this);
+    }
+
+    /**
+     * Get a particular element of the result of this expression
+     *
+     * @param r   The row index
+     * @param c   The column index
+     * @return    The value of the element
+     */
+    constexpr auto element(int r, int c) const
+    {
+        return derived().coeff(r, c);
+    }
+
+    /**
+     * Determine whether this expression reads from the given Matrix
+     * (i.e., whether it can be evaluated directly into it)
+     *
+     * @param m   The address of the Matrix
+     * @return    true if the Matrix is an operand; false otherwise
+     */
+    bool aliases(const void* m) const
+    {
+        return derived().refersTo(m);
+    }
+
+    /**
+     * Evaluate this expression into the given Matrix
+     *
+     * Note: The destination must not be one of the operands (see aliases())
+     *
+     * @param dest   The Matrix to evaluate into
+     */
+    template <class T>
+    void evalTo(Matrix<R,C,T>& dest) const
+    {
+        derived().evaluateInto(dest);
+    }
+
+    /**
+     * Evaluate this expression element by element (this is the default
+     * evaluation strategy of all expressions)
+     *
+     * @param dest   The Matrix to evaluate into
+     */
+    template <class T>
+    void evaluateInto(Matrix<R,C,T>& dest) const
+    {
+        for(int r = 0; r < R; ++r)
+        {
+            for(int c = 0; c < C; ++c)
+                dest.values[r][c] = element(r, c);
+        }
+    }
+};
+
+
+/**
+ * How an expression stores its operands. Matrix operands are stored
+ * by reference (since they outlive the expression), all other
+ * operands are (small) temporaries and are stored by value.
+ */
+template <class E>
+struct ExpressionNesting
+{
+    typedef E type;
+};
+
+template <int R, int C, class T>
+struct ExpressionNesting< Matrix<R,C,T> >
+{
+    typedef const Matrix<R,C,T>& type;
+};
+
+
+/**
+ * How a product stores its operands. Matrix operands are stored by
+ * reference, all other operands are evaluated into a Matrix when the
+ * product is created.
+ */
+template <class E, int R, int C>
+struct ProductNesting
+{
+    typedef Matrix<R,C,typename E::Scalar> type;
+};
+
+template <int R, int C, class T>
+struct ProductNesting<Matrix<R,C,T>,R,C>
+{
+    typedef const Matrix<R,C,T>& type;
+};
+
+
+/**
+ * The (lazy) sum of two R x C expressions
+ */
+template <class L, class Rt, int R, int C>
+class MatrixSum: public MatrixExpression<MatrixSum<L,Rt,R,C>,R,C>
+{
+  private:
+    typename ExpressionNesting<L>::type    lhs;
+    typename ExpressionNesting<Rt>::type   rhs;
+
+  public:
+    typedef typename L::Scalar Scalar;
+
+    static_assert(std::is_same<Scalar, typename Rt::Scalar>::value,
+                  "Matrix expressions can't mix element types");
+
+    MatrixSum(const L& a, const Rt& b): lhs(a), rhs(b) {}
+
+    Scalar coeff(int r, int c) const
+    {
+        return lhs.element(r,c) + rhs.element(r,c);
+    }
+
+    bool refersTo(const void* m) const
+    {
+        return lhs.aliases(m) || rhs.aliases(m);
+    }
+};
+
+
+/**
+ * The (lazy) difference of two R x C expressions
+ */
+template <class L, class Rt, int R, int C>
+class MatrixDifference: public MatrixExpression<MatrixDifference<L,Rt,R,C>,R,C>
+{
+  private:
+    typename ExpressionNesting<L>::type    lhs;
+    typename ExpressionNesting<Rt>::type   rhs;
+
+  public:
+    typedef typename L::Scalar Scalar;
+
+    static_assert(std::is_same<Scalar, typename Rt::Scalar>::value,
+                  "Matrix expressions can't mix element types");
+
+    MatrixDifference(const L& a, const Rt& b): lhs(a), rhs(b) {}
+
+    Scalar coeff(int r, int c) const
+    {
+        return lhs.element(r,c) - rhs.element(r,c);
+    }
+
+    bool refersTo(const void* m) const
+    {
+        return lhs.aliases(m) || rhs.aliases(m);
+    }
+};
+
+
+/**
+ * The (lazy) product of a scalar and an R x C expression
+ */
+template <class E, int R, int C>
+class MatrixScaled: public MatrixExpression<MatrixScaled<E,R,C>,R,C>
+{
+  public:
+    typedef typename E::Scalar Scalar;
+
+  private:
+    Scalar                               k;
+    typename ExpressionNesting<E>::type  a;
+
+  public:
+    MatrixScaled(Scalar k, const E& a): k(k), a(a) {}
+
+    Scalar coeff(int r, int c) const
+    {
+        return k * a.element(r,c);
+    }
+
+    bool refersTo(const void* m) const
+    {
+        return a.aliases(m);
+    }
+};
+
+
+/**
+ * The (lazy) product of an RL x CLRR expression and a CLRR x CR expression
+ */
+template <class L, class Rt, int RL, int CLRR, int CR>
+class MatrixProductExpression:
+    public MatrixExpression<MatrixProductExpression<L,Rt,RL,CLRR,CR>,RL,CR>
+{
+  private:
+    typename ProductNesting<L,RL,CLRR>::type    lhs;
+    typename ProductNesting<Rt,CLRR,CR>::type   rhs;
+
+  public:
+    typedef typename L::Scalar Scalar;
+
+    static_assert(std::is_same<Scalar, typename Rt::Scalar>::value,
+                  "Matrix expressions can't mix element types");
+
+    MatrixProductExpression(const L& a, const Rt& b): lhs(a), rhs(b) {}
+
+    Scalar coeff(int r, int c) const
+    {
+        Scalar result = Scalar();
+        for(int index = 0; index < CLRR; ++index)
+            result += lhs.element(r,index) * rhs.element(index,c);
+        return result;
+    }
+
+    void evaluateInto(Matrix<RL,CR,Scalar>& dest) const
+    {
+        typedef typename std::decay<decltype(lhs)>::type   LeftOperand;
+        typedef typename std::decay<decltype(rhs)>::type   RightOperand;
+
+        // If both operands are Matrix objects use the (specialized) kernel,
+        // otherwise (e.g., for views) calculate the elements one at a time
+        if constexpr (std::is_same<LeftOperand, Matrix<RL,CLRR,Scalar> >::value &&
+                      std::is_same<RightOperand, Matrix<CLRR,CR,Scalar> >::value)
+            MatrixMultiply<RL,CLRR,CR,Scalar>::multiply(lhs, rhs, dest);
+        else
+            MatrixExpression<MatrixProductExpression,RL,CR>::evaluateInto(dest);
+    }
+
+    bool refersTo(const void* m) const
+    {
+        return lhs.aliases(m) || rhs.aliases(m);
+    }
+};
+
+
+/**
+ * Start a lazy expression with the given Matrix
+ *
+ * @param a   The Matrix
+ * @return    a as an expression
+ */
+template <int R, int C, class T>
+const MatrixExpression<Matrix<R,C,T>,R,C>& lazy(const Matrix<R,C,T>& a)
+{
+    return a;
+}
+
+
+/**
+ * Add two R x C expressions
+ *
+ * @param a   The left expression
+ * @param b   The right expression
+ * @return    The (unevaluated) expression a+b
+ */
+template <class L, class Rt, int R, int C>
+MatrixSum<L,Rt,R,C> operator+(const MatrixExpression<L,R,C>& a,
+                              const MatrixExpression<Rt,R,C>& b)
+{
+    return MatrixSum<L,Rt,R,C>(a.derived(), b.derived());
+}
+
+
+/**
+ * Subtract the R x C expression b from the R x C expression a
+ *
+ * @param a   The left expression
+ * @param b   The right expression
+ * @return    The (unevaluated) expression a-b
+ */
+template <class L, class Rt, int R, int C>
+MatrixDifference<L,Rt,R,C> operator-(const MatrixExpression<L,R,C>& a,
+                                     const MatrixExpression<Rt,R,C>& b)
+{
+    return MatrixDifference<L,Rt,R,C>(a.derived(), b.derived());
+}
+
+
+/**
+ * Multiply the RL x CLRR expression a and the CLRR x CR expression b
+ *
+ * @param a   The left expression
+ * @param b   The right expression
+ * @return    The (unevaluated) expression a*b
+ */
+template <class L, class Rt, int RL, int CLRR, int CR>
+MatrixProductExpression<L,Rt,RL,CLRR,CR>
+operator*(const MatrixExpression<L,RL,CLRR>& a,
+          const MatrixExpression<Rt,CLRR,CR>& b)
+{
+    return MatrixProductExpression<L,Rt,RL,CLRR,CR>(a.derived(), b.derived());
+}
+
+
+/**
+ * Multiply a scalar and an R x C expression
+ *
+ * @param k   The scalar
+ * @param a   The expression
+ * @return    The (unevaluated) expression k*a
+ */
+template <class E, int R, int C>
+MatrixScaled<E,R,C> operator*(typename E::Scalar k,
+                              const MatrixExpression<E,R,C>& a)
+{
+    return MatrixScaled<E,R,C>(k, a.derived());
+}
+
+
+/**
+ * Multiply an R x C expression and a scalar
+ *
+ * @param a   The expression
+ * @param k   The scalar
+ * @return    The (unevaluated) expression k*a
+ */
+template <class E, int R, int C>
+MatrixScaled<E,R,C> operator*(const MatrixExpression<E,R,C>& a,
+                              typename E::Scalar k)
+{
+    return MatrixScaled<E,R,C>(k, a.derived());
+}
+
+#endif
@@ -0,0 +1,286 @@
+/**
+ * Matrix multiplication kernels
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __cs_matrix_kernels_hpp__
+#define __cs_matrix_kernels_hpp__
+
+/**
+ * Specialized (SIMD) versions of MatrixMultiply for the products that
+ * are used to transform homogeneous points:
+ *
+ *   Matrix<4,4> * Matrix<4,1>   (one point)
+ *   Matrix<4,4> * Matrix<4,N>   (N points, e.g., the vertices of a Triangle)
+ *                               (which includes Matrix<4,4> * Matrix<4,4>)
+ *
+ * and of the latter for float elements (which fit twice as many
+ * elements in a register).
+ *
+ * The instruction set is chosen at compile time: AVX (with FMA if it is
+ * available, e.g., -mavx2 -mfma or -march=native), then SSE2 (which is
+ * always available on x86-64), and then the generic (scalar) version in
+ * Matrix.hpp. Defining MATRIX_NO_SIMD forces the scalar version.
+ *
+ * Note: This file is included at the end of Matrix.hpp and should not be
+ * included directly.
+ */
+
+#if !defined(MATRIX_NO_SIMD) && defined(__AVX__)
+#define MATRIX_SIMD_AVX
+#include <immintrin.h>
+#elif !defined(MATRIX_NO_SIMD) && defined(__SSE2__)
+#define MATRIX_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+
+#if defined(MATRIX_SIMD_AVX)
+
+/**
+ * Calculate a*b + c (in one instruction if FMA is available)
+ */
+inline __m256d matrix_madd(__m256d a, __m256d b, __m256d c)
+{
+#ifdef __FMA__
+    return _mm256_fmadd_pd(a, b, c);
+#else
+    return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+}
+
+/**
+ * A mask that selects the first n (1 to 3) of four lanes
+ */
+inline __m256i matrix_mask(int n)
+{
+    return _mm256_setr_epi64x(n > 0 ? -1 : 0, n > 1 ? -1 : 0,
+                              n > 2 ? -1 : 0, 0);
+}
+
+
+/**
+ * Multiply a 4x4 Matrix and a 4x1 Matrix (i.e., transform a point)
+ *
+ * Each row of a is multiplied by b, and the four products are summed
+ * horizontally.
+ */
+template <>
+struct MatrixMultiply<4,4,1,double>
+{
+    static void multiply(const Matrix<4,4>& a, const Matrix<4,1>& b,
+                         Matrix<4,1>& result)
+    {
+        const double* A = &a.values[0][0];
+        __m256d       x = _mm256_loadu_pd(&b.values[0][0]);
+
+        __m256d m0 = _mm256_mul_pd(_mm256_loadu_pd(A),      x);
+        __m256d m1 = _mm256_mul_pd(_mm256_loadu_pd(A + 4),  x);
+        __m256d m2 = _mm256_mul_pd(_mm256_loadu_pd(A + 8),  x);
+        __m256d m3 = _mm256_mul_pd(_mm256_loadu_pd(A + 12), x);
+
+        // [m0_0+m0_1, m1_0+m1_1, m0_2+m0_3, m1_2+m1_3], and the same for 2,3
+        __m256d t0 = _mm256_hadd_pd(m0, m1);
+        __m256d t1 = _mm256_hadd_pd(m2, m3);
+
+        __m256d lo = _mm256_permute2f128_pd(t0, t1, 0x20);
+        __m256d hi = _mm256_permute2f128_pd(t0, t1, 0x31);
+
+        _mm256_storeu_pd(&result.values[0][0], _mm256_add_pd(lo, hi));
+    }
+};
+
+
+/**
+ * Multiply a 4x4 Matrix and a 4xCR Matrix (i.e., transform CR points)
+ *
+ * Each row of the result is a linear combination of the rows of b
+ * (with weights from the corresponding row of a), which is calculated
+ * four columns at a time.
+ */
+template <int CR>
+struct MatrixMultiply<4,4,CR,double>
+{
+    static void multiply(const Matrix<4,4>& a, const Matrix<4,CR>& b,
+                         Matrix<4,CR>& result)
+    {
+        const double* A = &a.values[0][0];
+        const double* B = &b.values[0][0];
+        double*       out = &result.values[0][0];
+
+        const int     full = CR - CR % 4;
+        const __m256i mask = matrix_mask(CR % 4);
+
+        for(int r = 0; r < 4; ++r)
+        {
+            __m256d a0 = _mm256_broadcast_sd(A + 4*r);
+            __m256d a1 = _mm256_broadcast_sd(A + 4*r + 1);
+            __m256d a2 = _mm256_broadcast_sd(A + 4*r + 2);
+            __m256d a3 = _mm256_broadcast_sd(A + 4*r + 3);
+
+            for(int c = 0; c < full; c += 4)
+            {
+                __m256d acc = _mm256_mul_pd(a0, _mm256_loadu_pd(B + c));
+                acc = matrix_madd(a1, _mm256_loadu_pd(B + CR + c),   acc);
+                acc = matrix_madd(a2, _mm256_loadu_pd(B + 2*CR + c), acc);
+                acc = matrix_madd(a3, _mm256_loadu_pd(B + 3*CR + c), acc);
+                _mm256_storeu_pd(out + r*CR + c, acc);
+            }
+
+            if(full < CR)
+            {
+                // The last (partial) group of columns; the masked
+                // loads and stores never touch memory beyond a row
+                __m256d acc = _mm256_mul_pd(a0,
+                                  _mm256_maskload_pd(B + full, mask));
+                acc = matrix_madd(a1,
+                          _mm256_maskload_pd(B + CR + full, mask), acc);
+                acc = matrix_madd(a2,
+                          _mm256_maskload_pd(B + 2*CR + full, mask), acc);
+                acc = matrix_madd(a3,
+                          _mm256_maskload_pd(B + 3*CR + full, mask), acc);
+                _mm256_maskstore_pd(out + r*CR + full, mask, acc);
+            }
+        }
+    }
+};
+
+#elif defined(MATRIX_SIMD_SSE2)
+
+/**
+ * Multiply a 4x4 Matrix and a 4x1 Matrix (i.e., transform a point)
+ *
+ * Two rows of a are multiplied by b at a time, and the products are
+ * summed horizontally.
+ */
+template <>
+struct MatrixMultiply<4,4,1,double>
+{
+    static void multiply(const Matrix<4,4>& a, const Matrix<4,1>& b,
+                         Matrix<4,1>& result)
+    {
+        const double* A  = &a.values[0][0];
+        __m128d       xl = _mm_loadu_pd(&b.values[0][0]);
+        __m128d       xh = _mm_loadu_pd(&b.values[2][0]);
+
+        for(int r = 0; r < 4; r += 2)
+        {
+            __m128d s0 = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(A + 4*r),     xl),
+                                    _mm_mul_pd(_mm_loadu_pd(A + 4*r + 2), xh));
+            __m128d s1 = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(A + 4*r + 4), xl),
+                                    _mm_mul_pd(_mm_loadu_pd(A + 4*r + 6), xh));
+
+            _mm_storeu_pd(&result.values[r][0],
+                          _mm_add_pd(_mm_unpacklo_pd(s0, s1),
+                                     _mm_unpackhi_pd(s0, s1)));
+        }
+    }
+};
+
+
+/**
+ * Multiply a 4x4 Matrix and a 4xCR Matrix (i.e., transform CR points)
+ *
+ * Each row of the result is a linear combination of the rows of b
+ * (with weights from the corresponding row of a), which is calculated
+ * two columns at a time.
+ */
+template <int CR>
+struct MatrixMultiply<4,4,CR,double>
+{
+    static void multiply(const Matrix<4,4>& a, const Matrix<4,CR>& b,
+                         Matrix<4,CR>& result)
+    {
+        const double* A = &a.values[0][0];
+        const double* B = &b.values[0][0];
+        double*       out = &result.values[0][0];
+
+        const int     full = CR - CR % 2;
+
+        for(int r = 0; r < 4; ++r)
+        {
+            __m128d a0 = _mm_set1_pd(A[4*r]);
+            __m128d a1 = _mm_set1_pd(A[4*r + 1]);
+            __m128d a2 = _mm_set1_pd(A[4*r + 2]);
+            __m128d a3 = _mm_set1_pd(A[4*r + 3]);
+
+            for(int c = 0; c < full; c += 2)
+            {
+                __m128d acc = _mm_mul_pd(a0, _mm_loadu_pd(B + c));
+                acc = _mm_add_pd(acc, _mm_mul_pd(a1, _mm_loadu_pd(B + CR + c)));
+                acc = _mm_add_pd(acc, _mm_mul_pd(a2, _mm_loadu_pd(B + 2*CR + c)));
+                acc = _mm_add_pd(acc, _mm_mul_pd(a3, _mm_loadu_pd(B + 3*CR + c)));
+                _mm_storeu_pd(out + r*CR + c, acc);
+            }
+
+            if(full < CR)
+            {
+                // The last column
+                __m128d acc = _mm_mul_sd(a0, _mm_load_sd(B + full));
+                acc = _mm_add_sd(acc, _mm_mul_sd(a1, _mm_load_sd(B + CR + full)));
+                acc = _mm_add_sd(acc, _mm_mul_sd(a2, _mm_load_sd(B + 2*CR + full)));
+                acc = _mm_add_sd(acc, _mm_mul_sd(a3, _mm_load_sd(B + 3*CR + full)));
+                _mm_store_sd(out + r*CR + full, acc);
+            }
+        }
+    }
+};
+
+#endif
+
+
+#if defined(MATRIX_SIMD_AVX) || defined(MATRIX_SIMD_SSE2)
+
+/**
+ * Multiply a 4x4 Matrix and a 4xCR Matrix of float elements (i.e.,
+ * transform CR points)
+ *
+ * This is the same algorithm as the double version, but four columns
+ * fit in one SSE register.
+ */
+template <int CR>
+struct MatrixMultiply<4,4,CR,float>
+{
+    static void multiply(const Matrix<4,4,float>& a,
+                         const Matrix<4,CR,float>& b,
+                         Matrix<4,CR,float>& result)
+    {
+        const float* A = &a.values[0][0];
+        const float* B = &b.values[0][0];
+        float*       out = &result.values[0][0];
+
+        const int    full = CR - CR % 4;
+
+        for(int r = 0; r < 4; ++r)
+        {
+            __m128 a0 = _mm_set1_ps(A[4*r]);
+            __m128 a1 = _mm_set1_ps(A[4*r + 1]);
+            __m128 a2 = _mm_set1_ps(A[4*r + 2]);
+            __m128 a3 = _mm_set1_ps(A[4*r + 3]);
+
+            for(int c = 0; c < full; c += 4)
+            {
+                __m128 acc = _mm_mul_ps(a0, _mm_loadu_ps(B + c));
+                acc = _mm_add_ps(acc, _mm_mul_ps(a1, _mm_loadu_ps(B + CR + c)));
+                acc = _mm_add_ps(acc, _mm_mul_ps(a2, _mm_loadu_ps(B + 2*CR + c)));
+                acc = _mm_add_ps(acc, _mm_mul_ps(a3, _mm_loadu_ps(B + 3*CR + c)));
+                _mm_storeu_ps(out + r*CR + c, acc);
+            }
+
+            // The last (partial) group of columns
+            for(int c = full; c < CR; ++c)
+            {
+                out[r*CR + c] = A[4*r]     * B[c]
+                              + A[4*r + 1] * B[CR + c]
+                              + A[4*r + 2] * B[2*CR + c]
+                              + A[4*r + 3] * B[3*CR + c];
+            }
+        }
+    }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * Matrix views
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __cs_matrix_view_hpp__
+#define __cs_matrix_view_hpp__
+
+#include <stdexcept>
+#include "MatrixExpression.hpp"
+
+/**
+ * A read-only, non-owning R x C view of (some of) the elements of a
+ * Matrix. A view is a pointer and two strides, so creating one never
+ * copies the elements it refers to. Views are created by the Matrix
+ * methods columnView(), rowView() and blockView(), and by transView().
+ *
+ * Example of use:
+ *
+ *     if(inside<2>(p, t.columnView(0), t.columnView(1), t.columnView(2)))
+ *
+ * Since a view is an expression (see MatrixExpression.hpp) it can be
+ * used with dot(), det(), operator* and the other lazy operators, and
+ * it can be assigned to (or used to construct) a Matrix.
+ *
+ * Note: A view refers to the elements of its Matrix, so it must not
+ * outlive it.
+ */
+template <int R, int C, class T = double>
+class MatrixView: public MatrixExpression<MatrixView<R,C,T>,R,C>
+{
+  private:
+    const T*     first;
+    int          rowStride;
+    int          columnStride;
+    const void*  source;
+
+  public:
+    typedef T Scalar;
+
+    /**
+     * Construct a view of the elements first[r*rowStride + c*columnStride]
+     *
+     * @param first         A pointer to the element in row 0 and column 0
+     * @param rowStride     The distance between consecutive rows
+     * @param columnStride  The distance between consecutive columns
+     * @param source        The Matrix that contains the elements
+     */
+    constexpr MatrixView(const T* first, int rowStride, int columnStride,
+                         const void* source)
+        : first(first), rowStride(rowStride), columnStride(columnStride),
+          source(source)
+    {
+    }
+
+    /**
+     * Get a particular element of this R x C view
+     *
+     * @param r   The row index
+     * @param c   The column index
+     * @throws    out_of_range if r or c are out of bounds
+     * @return    The value of the element
+     */
+    constexpr T get(int r, int c) const
+    {
+        if(R-1 < r || C-1 < c || 0 > c || 0 > r)
+            throw std::out_of_range("get(int,int): out of range");
+        return coeff(r, c);
+    }
+
+    /**
+     * Get a particular element of this R x C view, where the indexes
+     * are known at compile time
+     *
+     * @param r   The row index
+     * @param c   The column index
+     * @return    The value of the element
+     */
+    template <int r, int c>
+    constexpr T get() const
+    {
+        static_assert(0 <= r && r < R && 0 <= c && c < C, "get<r,c>(): out of range");
+        return coeff(r, c);
+    }
+
+    /**
+     * Get the number of columns in this R x C view
+     *
+     * @return  The number of columns (i.e., C)
+     */
+    constexpr int getColumns() const
+    {
+        return C;
+    }
+
+    /**
+     * Get the number of rows in this R x C view
+     *
+     * @return  The number of rows (i.e., R)
+     */
+    constexpr int getRows() const
+    {
+        return R;
+    }
+
+    /**
+     * Get a particular element of this R x C view without checking
+     * the indexes (for use by expressions)
+     *
+     * @param r   The row index
+     * @param c   The column index
+     * @return    The value of the element
+     */
+    constexpr T coeff(int r, int c) const
+    {
+        return first[r*rowStride + c*columnStride];
+    }
+
+    /**
+     * Determine whether this view refers to the given Matrix
+     *
+     * @param m   The address of the Matrix
+     * @return    true if this is a view of m; false otherwise
+     */
+    bool refersTo(const void* m) const
+    {
+        return source == m;
+    }
+};
+
+
+/**
+ * How a product stores a view operand (i.e., by value, since it is
+ * smaller than the elements it refers to)
+ */
+template <int R, int C, class T>
+struct ProductNesting<MatrixView<R,C,T>,R,C>
+{
+    typedef MatrixView<R,C,T> type;
+};
+
+#endif
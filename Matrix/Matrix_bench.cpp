@@ -0,0 +1,237 @@
+/**
+ * Matrix and Vector benchmark
+ *
+ * Times the basic operations of Matrix.hpp and Vector.hpp (so that
+ * changes to them can be checked for regressions). Along with the time,
+ * it reports the number of heap allocations (and bytes) per iteration.
+ *
+ * Build with, for example:
+ *
+ *   g++ -std=c++17 -O2 Matrix_bench.cpp -lbenchmark -lpthread
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "AllocationCounter.h"
+#include "Matrix.hpp"
+#include "Vector.hpp"
+#include "DynamicMatrix.hpp"
+
+/**
+ * Create an R x C Matrix with distinct, non-trivial elements (so that,
+ * for example, the square ones aren't singular)
+ *
+ * @return   The Matrix
+ */
+template <int R, int C>
+static Matrix<R,C> sample()
+{
+    Matrix<R,C> m;
+
+    for (int r = 0; r < R; ++r)
+        for (int c = 0; c < C; ++c)
+            m(r,c) = 1.0 + r * 0.75 - c * 0.5 + (r == c ? 3.0 : 0.0);
+
+    return m;
+}
+
+/**
+ * Reset the counters before the timed loop
+ */
+static void startCounting()
+{
+    AllocationCounter::reset();
+}
+
+/**
+ * Report the counters (per iteration) after the timed loop
+ */
+static void reportCounts(benchmark::State& state)
+{
+    double n = (double)state.iterations();
+
+    state.counters["allocs/op"] = AllocationCounter::allocations / n;
+    state.counters["bytes/op"]  = AllocationCounter::bytes / n;
+}
+
+static void BM_Construct(benchmark::State& state)
+{
+    double x = 1.5;
+
+    startCounting();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(x);
+        Matrix<4,4> m({x, 0, 0, 1,
+                       0, x, 0, 2,
+                       0, 0, x, 3,
+                       0, 0, 0, 1});
+        benchmark::DoNotOptimize(m);
+    }
+    reportCounts(state);
+}
+BENCHMARK(BM_Construct);
+
+static void BM_Copy(benchmark::State& state)
+{
+    Matrix<4,4> a = sample<4,4>();
+
+    startCounting();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a);
+        Matrix<4,4> b(a);
+        benchmark::DoNotOptimize(b);
+    }
+    reportCounts(state);
+}
+BENCHMARK(BM_Copy);
+
+template <int RL, int CLRR, int CR>
+static void BM_Multiply(benchmark::State& state)
+{
+    Matrix<RL,CLRR> a = sample<RL,CLRR>();
+    Matrix<CLRR,CR> b = sample<CLRR,CR>();
+    Matrix<RL,CR>   result;
+
+    startCounting();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a);
+        result = a * b;
+        benchmark::DoNotOptimize(result);
+    }
+    reportCounts(state);
+}
+BENCHMARK_TEMPLATE(BM_Multiply, 2, 2, 2);
+BENCHMARK_TEMPLATE(BM_Multiply, 3, 3, 3);
+BENCHMARK_TEMPLATE(BM_Multiply, 4, 4, 4);
+BENCHMARK_TEMPLATE(BM_Multiply, 4, 4, 3);
+
+template <int RC>
+static void BM_Det(benchmark::State& state)
+{
+    Matrix<RC,RC> a = sample<RC,RC>();
+
+    startCounting();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a);
+        double d = det(a);
+        benchmark::DoNotOptimize(d);
+    }
+    reportCounts(state);
+}
+BENCHMARK_TEMPLATE(BM_Det, 2);
+BENCHMARK_TEMPLATE(BM_Det, 3);
+BENCHMARK_TEMPLATE(BM_Det, 4);
+BENCHMARK_TEMPLATE(BM_Det, 6);
+
+static void BM_Dot(benchmark::State& state)
+{
+    Matrix<4,1> a = sample<4,1>();
+    Matrix<4,1> b = sample<4,1>();
+
+    startCounting();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a);
+        double d = dot(a, b);
+        benchmark::DoNotOptimize(d);
+    }
+    reportCounts(state);
+}
+BENCHMARK(BM_Dot);
+
+static void BM_Concatenate(benchmark::State& state)
+{
+    Matrix<4,3> a = sample<4,3>();
+    Matrix<4,1> b = sample<4,1>();
+    Matrix<4,4> result;
+
+    startCounting();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a);
+        result = a | b;
+        benchmark::DoNotOptimize(result);
+    }
+    reportCounts(state);
+}
+BENCHMARK(BM_Concatenate);
+
+static void BM_GetColumn(benchmark::State& state)
+{
+    Matrix<4,3> a = sample<4,3>();
+    Matrix<4,1> result;
+
+    startCounting();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a);
+        result = a.getColumn(1);
+        benchmark::DoNotOptimize(result);
+    }
+    reportCounts(state);
+}
+BENCHMARK(BM_GetColumn);
+
+static void BM_Trans(benchmark::State& state)
+{
+    Matrix<4,3> a = sample<4,3>();
+    Matrix<3,4> result;
+
+    startCounting();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a);
+        result = trans(a);
+        benchmark::DoNotOptimize(result);
+    }
+    reportCounts(state);
+}
+BENCHMARK(BM_Trans);
+
+static void BM_Normalized(benchmark::State& state)
+{
+    Vector<3>   v;
+    Matrix<3,1> result;
+
+    v = {3.0, -4.0, 12.0};
+
+    startCounting();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(v);
+        result = normalized(v);
+        benchmark::DoNotOptimize(result);
+    }
+    reportCounts(state);
+}
+BENCHMARK(BM_Normalized);
+
+static void BM_TransformMesh(benchmark::State& state)
+{
+    Matrix<4,4>     view = sample<4,4>();
+    DynamicMatrix<> vertices(4, state.range(0));
+    DynamicMatrix<> result(4, state.range(0));
+
+    for (int c = 0; c < state.range(0); ++c)
+        vertices.setBlock(0, c, sample<4,1>());
+
+    DynamicMatrix<> a(view);
+    startCounting();
+    for (auto _ : state)
+    {
+        multiply(a, vertices, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    reportCounts(state);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformMesh)->Arg(3 * 1000)->Arg(3 * 100000)->UseRealTime();
+
+BENCHMARK_MAIN();
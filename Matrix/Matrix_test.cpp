@@ -11,6 +11,11 @@
 #include <gtest/gtest.h>
 
 #include "Matrix.hpp"
+#include "FixedPoint.hpp"
+#include "AffineTransform.hpp"
+#include "Quaternion.hpp"
+#include "DynamicMatrix.hpp"
+#include "TransformStack.hpp"
 
 #define DESC(func, desc) cout << "[ TEST     ] " << func << endl << "[ DESC     ] " << desc << end
 
@@ -55,6 +60,31 @@ TEST_F(MatrixUnittest, constructor_copy_valid)
     EXPECT_EQ(test(1,2), 2);
 }
 
+/**
+ * Test copy construct, the copy should not share storage with the original
+ */
+TEST_F(MatrixUnittest, constructor_copy_independent)
+{
+    Matrix<3,3> test(a);
+    test(1,1) = 42;
+
+    EXPECT_EQ(test(1,1), 42);
+    EXPECT_EQ(a(1,1), 2);
+}
+
+/**
+ * Test storage layout, the elements should be stored inline, contiguously
+ * and aligned
+ */
+TEST_F(MatrixUnittest, storage_inline_valid)
+{
+    EXPECT_EQ(sizeof(Matrix<4,4>), 16 * sizeof(double));
+    EXPECT_EQ(alignof(Matrix<4,4>), MATRIX_ALIGNMENT);
+
+    Matrix<4,4> test;
+    EXPECT_EQ(reinterpret_cast<size_t>(&test) % MATRIX_ALIGNMENT, 0u);
+}
+
 /**
  * Test operator= initializer_list, should have correct value
  */
@@ -74,6 +104,29 @@ TEST_F(MatrixUnittest, operator_initlist_assign_valid2)
     EXPECT_EQ(b(1,1), 49.2);
 }
 
+/**
+ * Test the element constructor and assign()
+ * they should be evaluated at compile time and match the initializer_list
+ */
+TEST_F(MatrixUnittest, element_constructor_valid)
+{
+    constexpr Matrix<2,3> m(1, 2, 3,
+                            4, 5, 6.5);
+    static_assert(m.get<1,2>() == 6.5, "element constructor is constexpr");
+
+    Matrix<2,3> expected;
+    expected = {1, 2, 3, 4, 5, 6.5};
+    EXPECT_EQ(m, expected);
+
+    Matrix<2,1> p;
+    int x = 7, y = -2;
+    EXPECT_EQ(p.assign(x, y), (Matrix<2,1>(7, -2)));
+    EXPECT_EQ(p(1,0), -2);
+
+    Matrix<2,1> q = {1.5, 2.5};
+    EXPECT_EQ(q(0,0), 1.5);
+}
+
 /**
  * Test operator= initializer_list with unmatched dimension matrix
  * it should throw length error expcetion
@@ -832,3 +885,614 @@ TEST_F(MatrixUnittest, minor_valid2)
 {
 
 }
+
+/**
+ * test move constructor and move assignment
+ * the destination should have the values of the moved Matrix
+ */
+TEST_F(MatrixUnittest, move_valid)
+{
+    Matrix<2,2> temp(b);
+    Matrix<2,2> result(std::move(temp));
+
+    EXPECT_EQ(result, b);
+
+    Matrix<2,2> result2;
+    result2 = b + d;
+
+    EXPECT_EQ(result2(0,0), 1.03 + 3.59);
+    EXPECT_EQ(result2(1,1), 49.2 + 9.2413);
+}
+
+/**
+ * test lazy element-wise expressions
+ * they should have the same values as the eager operators
+ */
+TEST_F(MatrixUnittest, lazy_elementwise_valid)
+{
+    Matrix<2,2> result;
+    result = lazy(b) + d - 2.0 * b;
+
+    EXPECT_EQ(result, b + d - 2.0 * b);
+
+    result = lazy(d) * 0.5;
+    EXPECT_EQ(result, 0.5 * d);
+}
+
+/**
+ * test lazy products
+ * they should have the same values as the eager operators
+ */
+TEST_F(MatrixUnittest, lazy_product_valid)
+{
+    Matrix<3,5> result;
+    result = lazy(a) * a * c;
+
+    EXPECT_EQ(result, a * a * c);
+
+    Matrix<3,5> result2 = lazy(a) * c + c;
+    EXPECT_EQ(result2, a * c + c);
+}
+
+/**
+ * test lazy products that are assigned to one of their operands
+ * the operand should not be overwritten before it has been used
+ */
+TEST_F(MatrixUnittest, lazy_product_alias_valid)
+{
+    Matrix<2,2> expect;
+    expect = b * d;
+
+    b = lazy(b) * d;
+    EXPECT_EQ(b, expect);
+}
+
+/**
+ * Multiply two matrices element by element (i.e., without the
+ * specialized kernels) for comparison
+ */
+template <int RL, int CLRR, int CR>
+Matrix<RL,CR> referenceProduct(const Matrix<RL,CLRR>& a,
+                               const Matrix<CLRR,CR>& b)
+{
+    Matrix<RL,CR> result;
+    for(int r = 0; r < RL; ++r)
+        for(int c = 0; c < CR; ++c)
+            for(int k = 0; k < CLRR; ++k)
+                result(r,c) += a.get(r,k) * b.get(k,c);
+    return result;
+}
+
+/**
+ * test the 4x4 kernels of operator* 
+ * they should have the same values as the element by element product
+ */
+TEST_F(MatrixUnittest, operator_multiply_kernel_valid)
+{
+    Matrix<4,4> m;
+    Matrix<4,1> v;
+    Matrix<4,3> t;
+    Matrix<4,5> w;
+
+    m = { 0.5, -1.25, 3.0, 10.0,
+          2.0,  0.75, -4.5, -2.0,
+         -3.5,  1.0,  0.25, 7.0,
+          0.0,  0.0,  0.02, 1.0 };
+    v = { 1.5, -2.0, 3.25, 1.0 };
+    t = { 1, 2, 3,
+          4, 5, 6,
+         -7, 8, -9,
+          1, 1, 1 };
+    for(int r = 0; r < 4; ++r)
+        for(int c = 0; c < 5; ++c)
+            w(r,c) = r * 1.5 - c * 0.75;
+
+    EXPECT_EQ(m * v, referenceProduct(m, v));
+    EXPECT_EQ(m * t, referenceProduct(m, t));
+    EXPECT_EQ(m * m, referenceProduct(m, m));
+    EXPECT_EQ(m * w, referenceProduct(m, w));
+}
+
+/**
+ * test det(Matrix) with a matrix that is larger than 4x4
+ * it should return correct determinant of matrix (using LU decomposition)
+ */
+TEST_F(MatrixUnittest, det_valid5)
+{
+    Matrix<5,5> ta;
+
+    ta = { 2, 0, 1, 3, 1,
+           1, 4, 0, 2, 2,
+           0, 1, 3, 1, 0,
+           5, 2, 1, 0, 1,
+           1, 1, 1, 1, 6 };
+
+    EXPECT_NEAR(det(ta), -1010, 1e-9);
+}
+
+/**
+ * test det(Matrix) and inverse(Matrix) with a badly scaled (but not
+ * singular) matrix that is larger than 4x4
+ * the small pivot should not be treated as 0
+ */
+TEST_F(MatrixUnittest, det_valid5_scaled)
+{
+    Matrix<5,5> ta;
+
+    ta = { 1e10, 0,     0, 0, 0,
+           0,    1e-10, 0, 0, 0,
+           0,    0,     1, 0, 0,
+           0,    0,     0, 1, 0,
+           0,    0,     0, 0, 1 };
+
+    EXPECT_DOUBLE_EQ(det(ta), 1);
+    EXPECT_DOUBLE_EQ(LUDecomposition<5>(ta).det(), 1);
+
+    Matrix<5,5> inv = inverse(ta);
+    EXPECT_DOUBLE_EQ(inv.get(0,0), 1e-10);
+    EXPECT_DOUBLE_EQ(inv.get(1,1), 1e10);
+    EXPECT_DOUBLE_EQ(inv.get(4,4), 1);
+
+    // The same rows in another order (so that the rows are swapped)
+    ta = { 0,    0,     1, 0, 0,
+           0,    1e-10, 0, 0, 1,
+           1e10, 0,     0, 0, 0,
+           0,    0,     0, 1, 0,
+           0,    0,     0, 0, 1 };
+    EXPECT_DOUBLE_EQ(fabs(det(ta)), 1);
+    EXPECT_FALSE(LUDecomposition<5>(ta).isSingular());
+}
+
+/**
+ * test inverse(Matrix) with valid matrices
+ * the product of a matrix and its inverse should be the identity
+ */
+TEST_F(MatrixUnittest, inverse_valid)
+{
+    Matrix<4,4> ta;
+
+    ta = { 5, 2, 9, 1,
+           0, 3, 4, 8,
+           7, 2, 10, 3,
+           1, 5, 4, 1 };
+
+    EXPECT_EQ(ta * inverse(ta), identity<4>());
+    EXPECT_EQ(inverse(b) * b, identity<2>());
+}
+
+/**
+ * test inverse(Matrix) with a singular matrix
+ * it should throw domain error
+ */
+TEST_F(MatrixUnittest, inverse_invalid)
+{
+    EXPECT_THROW(inverse(a), std::domain_error);
+}
+
+/**
+ * test solve(Matrix, Matrix) with valid matrices
+ * it should return x such that a*x = b
+ */
+TEST_F(MatrixUnittest, solve_valid)
+{
+    Matrix<3,3> ta;
+    Matrix<3,1> tb, expect;
+
+    ta = { 2, 4, 3,
+           5, 1, 0,
+           9, 2, 1 }; 
+    expect = { 1, -2, 3 };
+    tb = ta * expect;
+
+    EXPECT_EQ(solve(ta, tb), expect);
+}
+
+/**
+ * test get<r,c>() and get<i>() with valid indexes
+ * they should return the same values as get(r,c) and get(i)
+ */
+TEST_F(MatrixUnittest, get_static_valid)
+{
+    Matrix<3,1> v;
+    v = { 3.45135, 9.214241, 0.231255 };
+
+    EXPECT_EQ((b.get<0,1>()), 1.49);
+    EXPECT_EQ((c.get<2,4>()), 6);
+    EXPECT_EQ(v.get<2>(), v.get(2));
+
+    b.get<1,0>() = 7.5;
+    EXPECT_EQ(b(1,0), 7.5);
+}
+
+/**
+ * test data(), rowPointer(int) and columnPointer(int)
+ * they should point to the row-major elements
+ */
+TEST_F(MatrixUnittest, pointer_access_valid)
+{
+    const Matrix<3,5>& tc = c;
+
+    EXPECT_EQ(tc.data()[5], 5);
+    EXPECT_EQ(tc.rowPointer(2)[3], 6);
+    EXPECT_EQ(tc.columnPointer(1)[2 * tc.getColumns()], 6);
+
+    c.rowPointer(1)[4] = -1;
+    EXPECT_EQ(c(1,4), -1);
+}
+
+/**
+ * test constexpr construction, identity, multiplication and det
+ * they should be evaluated at compile time
+ */
+TEST_F(MatrixUnittest, constexpr_valid)
+{
+    constexpr Matrix<2,2> m({1, 2,
+                             3, 4});
+    constexpr Matrix<2,2> product = m * identity<2>();
+    constexpr Matrix<4,4> square  = identity<4>() * (2.0 * identity<4>());
+
+    static_assert(m.get<1,0>() == 3, "element array constructor");
+    static_assert(product == m, "constexpr multiplication");
+    static_assert(det(m) == -2, "constexpr det");
+    static_assert(det(square) == 16, "constexpr 4x4 det");
+    static_assert(trans(m).get<0,1>() == 3, "constexpr trans");
+
+    EXPECT_EQ(product.get(1,1), 4);
+}
+
+/**
+ * test Matrix objects with float elements
+ * they should have (approximately) the same values as double matrices
+ */
+TEST_F(MatrixUnittest, float_valid)
+{
+    Matrix<4,4,float> m;
+    Matrix<4,5,float> w;
+
+    m = { 0.5f, -1.25f, 3.0f, 10.0f,
+          2.0f,  0.0f, -4.5f,  1.0f,
+          7.25f, 1.5f,  0.25f, -2.0f,
+          0.0f,  0.0f,  0.0f,  1.0f };
+    w = { 1, 2, 3, 4, 5,
+          6, 7, 8, 9, 10,
+         -1,-2,-3,-4,-5,
+          1, 1, 1, 1, 1 };
+
+    Matrix<4,5,float> product = m * w;
+    Matrix<4,5>       expect  = Matrix<4,4>(m) * Matrix<4,5>(w);
+
+    for(int r = 0; r < 4; ++r)
+        for(int c = 0; c < 5; ++c)
+            EXPECT_FLOAT_EQ(product(r,c), expect(r,c));
+
+    EXPECT_FLOAT_EQ(det(m), det(Matrix<4,4>(m)));
+    EXPECT_EQ((Matrix<2,2>(Matrix<2,2,float>(b))), b);
+}
+
+/**
+ * test Matrix objects with fixed-point (int32) elements
+ * sums, products and determinants should be exact
+ */
+TEST_F(MatrixUnittest, fixed_point_valid)
+{
+    typedef FixedPoint<16> Fixed;
+
+    Matrix<3,3,Fixed> m;
+    m = { 2, -1,  0,
+          1,  3,  2,
+          0,  1,  4 };
+
+    Matrix<3,3,Fixed> half(Matrix<3,3>(0.5 * identity<3>()));
+
+    EXPECT_EQ(det(m), Fixed(24));
+    EXPECT_EQ((m * identity<3,Fixed>()), m);
+    EXPECT_EQ((m * half)(1,1), Fixed(1.5));
+    EXPECT_EQ((m + m)(2,2), Fixed(8));
+    EXPECT_EQ(dot(m, m), Fixed(36));
+    EXPECT_EQ(static_cast<double>(m.get<1,2>()), 2.0);
+
+    // A point on the boundary of a triangle must be exactly on it
+    Matrix<2,2,Fixed> edges;
+    edges = { Fixed(0.25), Fixed(0.75),
+              Fixed(0.5),  Fixed(1.5) };
+    EXPECT_EQ(det(edges), Fixed(0));
+}
+
+/**
+ * test columnView(), rowView(), blockView() and transView()
+ * they should refer to the same elements as getColumn(), trans(), ...
+ */
+TEST_F(MatrixUnittest, view_valid)
+{
+    Matrix<3,1> column = c.columnView(2);
+    EXPECT_EQ(column, c.getColumn(2));
+    EXPECT_EQ(c.rowView(1).get(0,3), 5);
+    EXPECT_EQ((c.blockView<2,2>(1,3).get<1,1>()), 6);
+
+    Matrix<5,3> transposed = transView(c);
+    EXPECT_EQ(transposed, trans(c));
+
+    // A view refers to (rather than copies) the elements
+    MatrixView<2,1> view = d.columnView(1);
+    d(1,1) = -2.5;
+    EXPECT_EQ(view.get(1,0), -2.5);
+
+    EXPECT_THROW(c.columnView(5), std::out_of_range);
+    EXPECT_THROW((c.blockView<2,2>(2,0)), std::out_of_range);
+}
+
+/**
+ * test dot(), det() and operator* with views
+ * they should have the same values as with the copied Matrix objects
+ */
+TEST_F(MatrixUnittest, view_operations_valid)
+{
+    EXPECT_DOUBLE_EQ(dot(c.columnView(0), c.columnView(4)),
+                     dot(c.getColumn(0), c.getColumn(4)));
+    EXPECT_DOUBLE_EQ(det(transView(b)), det(b));
+    EXPECT_DOUBLE_EQ(det(a.blockView<2,2>(0,1)), det(submatrix(a, 2, 0)));
+
+    Matrix<2,2> product = b * transView(d);
+    EXPECT_EQ(product, b * trans(d));
+
+    // The view is of the destination, so it must be evaluated first
+    b = lazy(b) * transView(b);
+    EXPECT_NEAR(b(0,1), 1.03*3.512 + 1.49*49.2, 1e-9);
+}
+
+/**
+ * test AffineTransform
+ * composing and applying should give the same result as the 4x4 Matrix
+ */
+TEST_F(MatrixUnittest, affine_valid)
+{
+    AffineTransform<> rx = AffineTransform<>::rotationX(0.3);
+    AffineTransform<> ry = AffineTransform<>::rotationY(-1.2);
+    AffineTransform<> t  = AffineTransform<>::translation(1.5, -2.0, 4.0);
+    AffineTransform<> s  = AffineTransform<>::scaling(2.5);
+
+    AffineTransform<> m = t * rx * ry * s;
+    EXPECT_EQ(m.toMatrix(), t.toMatrix() * rx.toMatrix() * ry.toMatrix() * s.toMatrix());
+    EXPECT_EQ(m.get(3,3), 1.0);
+    EXPECT_EQ(m.get(3,1), 0.0);
+
+    Matrix<4,3> points({1.0, -2.0, 0.5,
+                        3.0,  0.0, 7.0,
+                       -1.0,  4.0, 2.0,
+                        1.0,  1.0, 1.0});
+    Matrix<4,3> applied = m * points;
+    EXPECT_EQ(applied, m.toMatrix() * points);
+
+    Matrix<4,4> p({1,0,  0,0,
+                   0,1,  0,0,
+                   0,0,  0,0,
+                   0,0,0.2,1});
+    Matrix<4,4> perspective = p * m;
+    EXPECT_EQ(perspective, p * m.toMatrix());
+
+    EXPECT_EQ(AffineTransform<>(m.toMatrix()), m);
+    EXPECT_THROW(AffineTransform<>{p}, std::invalid_argument);
+}
+
+/**
+ * test AffineTransform::rigidInverse() and inverse()
+ * they should give the identity when composed with the transformation
+ */
+TEST_F(MatrixUnittest, affine_inverse_valid)
+{
+    AffineTransform<> rigid = AffineTransform<>::translation(1.5, -2.0, 4.0) *
+                              AffineTransform<>::rotationX(0.3) *
+                              AffineTransform<>::rotationZ(2.1);
+
+    EXPECT_EQ(rigid.rigidInverse() * rigid, AffineTransform<>());
+    EXPECT_EQ(rigid.inverse(), rigid.rigidInverse());
+
+    AffineTransform<> scaled = AffineTransform<>::scaling(4.0) * rigid;
+    EXPECT_EQ(scaled * scaled.inverse(), AffineTransform<>());
+    EXPECT_EQ(scaled.inverse().toMatrix(), inverse(scaled.toMatrix()));
+
+    // A small scale (whose determinant is far below TOLERANCE) isn't
+    // singular
+    AffineTransform<> small = AffineTransform<>::scaling(0.04) *
+                              AffineTransform<>::translation(1, 2, 3);
+    EXPECT_EQ(small * small.inverse(), AffineTransform<>());
+    EXPECT_EQ(small.inverse().toMatrix(), inverse(small.toMatrix()));
+
+    EXPECT_THROW(AffineTransform<>::scaling(0.0).inverse(), std::domain_error);
+}
+
+/**
+ * test Quaternion toMatrix(), operator* and rotate()
+ * they should match the rotation matrices
+ */
+TEST_F(MatrixUnittest, quaternion_valid)
+{
+    Quaternion<> qx = Quaternion<>::rotationX(0.3);
+    Quaternion<> qy = Quaternion<>::rotationY(-1.2);
+    Quaternion<> qz = Quaternion<>::rotationZ(2.1);
+
+    EXPECT_EQ(qx.toMatrix(), AffineTransform<>::rotationX(0.3).toMatrix());
+    EXPECT_EQ(qy.toMatrix(), AffineTransform<>::rotationY(-1.2).toMatrix());
+    EXPECT_EQ(qz.toMatrix(), AffineTransform<>::rotationZ(2.1).toMatrix());
+
+    Quaternion<> q = qx * qy * qz;
+    EXPECT_EQ(q.toMatrix(), qx.toMatrix() * qy.toMatrix() * qz.toMatrix());
+    EXPECT_EQ(q * q.conjugate(), Quaternion<>());
+
+    Matrix<3,1> axis({1, 1, 0});
+    EXPECT_EQ(Quaternion<>::fromAxisAngle(axis, 0.3 * 2),
+              Quaternion<>(cos(0.3), sin(0.3) / sqrt(2), sin(0.3) / sqrt(2), 0));
+
+    // A short axis (or a small quaternion) still has a direction
+    Matrix<3,1> shortAxis({1e-6, 0, 0});
+    EXPECT_EQ(Quaternion<>::fromAxisAngle(shortAxis, 0.3), qx);
+    EXPECT_EQ(normalized(Quaternion<>(1e-6 * cos(0.15), 1e-6 * sin(0.15), 0, 0)), qx);
+    EXPECT_THROW(Quaternion<>::fromAxisAngle(Matrix<3,1>(), 0.3), std::domain_error);
+
+    Matrix<3,1> p({1.5, -2.0, 4.0});
+    Matrix<4,1> h({1.5, -2.0, 4.0, 1.0});
+    Matrix<4,1> transformed = q.toMatrix() * h;
+    Matrix<3,1> expected    = transformed.blockView<3,1>(0,0);
+    EXPECT_EQ(q.rotate(p), expected);
+}
+
+/**
+ * test Quaternion::fromMatrix() and slerp()
+ */
+TEST_F(MatrixUnittest, quaternion_conversion_valid)
+{
+    // One rotation for each branch of fromMatrix()
+    Quaternion<> rotations[] = { Quaternion<>::rotationY(0.4) * Quaternion<>::rotationZ(0.2),
+                                 Quaternion<>::rotationX(3.0),
+                                 Quaternion<>::rotationY(3.0),
+                                 Quaternion<>::rotationZ(3.0) };
+    for(const Quaternion<>& q : rotations)
+        EXPECT_EQ(Quaternion<>::fromMatrix(q.toMatrix()), q);
+
+    EXPECT_THROW(Quaternion<>::fromMatrix(AffineTransform<>::translation(1, 0, 0).toMatrix()),
+                 std::invalid_argument);
+
+    Quaternion<> a = Quaternion<>::rotationZ(0.2);
+    Quaternion<> b = Quaternion<>::rotationZ(1.0);
+    EXPECT_EQ(slerp(a, b, 0.0), a);
+    EXPECT_EQ(slerp(a, b, 1.0), b);
+    EXPECT_EQ(slerp(a, b, 0.25), Quaternion<>::rotationZ(0.4));
+
+    // -b is the same rotation as b
+    Quaternion<> c(-b.getW(), -b.getX(), -b.getY(), -b.getZ());
+    EXPECT_EQ(slerp(a, c, 0.25), Quaternion<>::rotationZ(0.4));
+}
+
+/**
+ * test DynamicMatrix multiply()
+ * it should match the textbook product (including the partial blocks)
+ */
+TEST_F(MatrixUnittest, dynamic_multiply_valid)
+{
+    const int m = 37, k = 301, n = 263;
+    DynamicMatrix<> a(m, k), b(k, n), product;
+
+    for(int r = 0; r < m; ++r)
+        for(int c = 0; c < k; ++c)
+            a(r,c) = ((r * 7 + c * 3) % 11) - 5.0;
+    for(int r = 0; r < k; ++r)
+        for(int c = 0; c < n; ++c)
+            b(r,c) = ((r * 5 + c) % 13) * 0.5;
+
+    multiply(a, b, product);
+    ASSERT_EQ(product.getRows(), m);
+    ASSERT_EQ(product.getColumns(), n);
+    for(int r = 0; r < m; ++r)
+    {
+        for(int c = 0; c < n; ++c)
+        {
+            double expected = 0;
+            for(int p = 0; p < k; ++p)
+                expected += a.get(r,p) * b.get(p,c);
+            EXPECT_DOUBLE_EQ(product.get(r,c), expected);
+        }
+    }
+
+    EXPECT_THROW(multiply(b, b, product), std::length_error);
+    EXPECT_THROW(multiply(a, b, a), std::invalid_argument);
+}
+
+TEST_F(MatrixUnittest, dynamic_multiply_parallel_valid)
+{
+    // Enough work to be split across threads, in blocks of columns (the
+    // last of which is partial)
+    const int m = 61, k = 263, n = 1031;
+    ASSERT_GE((long)m * k * n, DYNAMIC_MATRIX_PARALLEL_WORK);
+    DynamicMatrix<> a(m, k), b(k, n), product;
+
+    for(int r = 0; r < m; ++r)
+        for(int c = 0; c < k; ++c)
+            a(r,c) = ((r * 7 + c * 3) % 11) - 5.0;
+    for(int r = 0; r < k; ++r)
+        for(int c = 0; c < n; ++c)
+            b(r,c) = ((r * 5 + c) % 13) * 0.5;
+
+    multiply(a, b, product);
+    ASSERT_EQ(product.getRows(), m);
+    ASSERT_EQ(product.getColumns(), n);
+    for(int r = 0; r < m; ++r)
+    {
+        for(int c = 0; c < n; ++c)
+        {
+            double expected = 0;
+            for(int p = 0; p < k; ++p)
+                expected += a.get(r,p) * b.get(p,c);
+            EXPECT_DOUBLE_EQ(product.get(r,c), expected);
+        }
+    }
+}
+
+/**
+ * test Matrix<4,4> * DynamicMatrix
+ * it should match transforming every block with the Matrix operator*
+ */
+TEST_F(MatrixUnittest, dynamic_matrix_interop_valid)
+{
+    Matrix<4,4>     view = AffineTransform<>::rotationX(0.3).toMatrix() *
+                           AffineTransform<>::translation(1, 2, 3).toMatrix();
+    Matrix<4,3>     triangle({1, 2, 3,
+                              4, 5, 6,
+                              7, 8, 9,
+                              1, 1, 1});
+    DynamicMatrix<> vertices(4, 3 * 50);
+
+    for(int t = 0; t < 50; ++t)
+        vertices.setBlock(0, 3 * t, (double)t * triangle);
+
+    DynamicMatrix<> transformed = view * vertices;
+    for(int t = 0; t < 50; ++t)
+        EXPECT_EQ((transformed.getBlock<4,3>(0, 3 * t)), view * ((double)t * triangle));
+
+    EXPECT_EQ((DynamicMatrix<>(triangle).getBlock<4,3>(0,0)), triangle);
+    EXPECT_THROW((vertices.getBlock<4,3>(0, 148)), std::out_of_range);
+    EXPECT_THROW(triangle * vertices, std::length_error);
+}
+
+/**
+ * test TransformStack
+ * the product should match the full product, and setting the last factor
+ * should only invalidate the last partial product
+ */
+TEST_F(MatrixUnittest, transform_stack_valid)
+{
+    Matrix<4,4> projection(1,0,  0,0,
+                           0,1,  0,0,
+                           0,0,  0,0,
+                           0,0,0.2,1);
+    AffineTransform<> t  = AffineTransform<>::translation(1, 2, 3);
+    AffineTransform<> rx = AffineTransform<>::rotationX(0.4);
+    TransformStack<4> stack;
+
+    EXPECT_EQ(stack.getProduct(), identity<4>());
+
+    stack.set(0, projection);
+    stack.set(1, t);
+    stack.set(2, rx);
+    stack.set(3, AffineTransform<>::rotationY(0.1));
+    EXPECT_EQ(stack.getDirty(), 0);
+    EXPECT_EQ(stack.getProduct(), projection * t.toMatrix() * rx.toMatrix() *
+                                  AffineTransform<>::rotationY(0.1).toMatrix());
+    EXPECT_EQ(stack.getDirty(), 4);
+
+    // Setting a factor to its current value invalidates nothing
+    stack.set(1, t);
+    EXPECT_EQ(stack.getDirty(), 4);
+
+    stack.set(3, AffineTransform<>::rotationY(0.7));
+    EXPECT_EQ(stack.getDirty(), 3);
+    EXPECT_EQ(stack.getProduct(), projection * t.toMatrix() * rx.toMatrix() *
+                                  AffineTransform<>::rotationY(0.7).toMatrix());
+    EXPECT_EQ(stack.get(1), t.toMatrix());
+    EXPECT_THROW(stack.set(4, t), std::out_of_range);
+
+    // Changes smaller than the tolerance of operator== still count
+    stack.getProduct();
+    stack.set(1, AffineTransform<>::translation(1 + 5e-5, 2, 3));
+    EXPECT_EQ(stack.getDirty(), 1);
+    EXPECT_EQ(stack.get(1).get(0,3), 1 + 5e-5);
+}
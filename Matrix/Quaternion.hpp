@@ -0,0 +1,552 @@
+/**
+ * Quaternion template
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __cs_quaternion_hpp__
+#define __cs_quaternion_hpp__
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "Matrix.hpp"
+#include "AffineTransform.hpp"
+
+/**
+ * A quaternion, w + xi + yj + zk. Unit quaternions represent rotations
+ * in 3-D: composing two of them takes 16 multiplications (rather than
+ * the 27 needed for the 3x3 part of two rotation matrices), and they
+ * can be interpolated (see slerp()).
+ *
+ * Example of use:
+ *
+ *   Quaternion<> camera = Quaternion<>::rotationX(phi) *
+ *                         Quaternion<>::rotationY(theta);
+ *
+ *   camera = normalized(Quaternion<>::rotationY(0.01) * camera);
+ *   Matrix<4,4> view = camera.toMatrix();
+ *
+ * Note: Rounding errors accumulate when many rotations are composed, so
+ * the result should be normalized now and then.
+ */
+template <class T = double>
+class Quaternion
+{
+  private:
+    T  w, x, y, z;
+
+  public:
+    typedef T Scalar;
+
+    /**
+     * Construct the identity rotation (i.e., 1 + 0i + 0j + 0k)
+     */
+    constexpr Quaternion();
+
+    /**
+     * Construct the quaternion w + xi + yj + zk
+     *
+     * @param w   The real part
+     * @param x   The i part
+     * @param y   The j part
+     * @param z   The k part
+     */
+    constexpr Quaternion(T w, T x, T y, T z);
+
+    /**
+     * Create a rotation around an axis
+     *
+     * @param axis    The axis (which need not be normalized)
+     * @param angle   The angle (in radians)
+     * @throws        domain_error if the axis is 0
+     * @return        The rotation
+     */
+    static Quaternion fromAxisAngle(const Matrix<3,1,T>& axis, T angle);
+
+    /**
+     * Create a rotation from the rotation in the upper-left 3x3 part of a
+     * 4x4 Matrix
+     *
+     * @param m   The Matrix (which must be a rotation)
+     * @throws    invalid_argument if m has a translation or a projection
+     * @return    The rotation
+     */
+    static Quaternion fromMatrix(const Matrix<4,4,T>& m);
+
+    /**
+     * Create a rotation around the x-axis
+     *
+     * @param angle   The angle (in radians)
+     * @return        The rotation
+     */
+    static Quaternion rotationX(T angle);
+
+    /**
+     * Create a rotation around the y-axis
+     *
+     * @param angle   The angle (in radians)
+     * @return        The rotation
+     */
+    static Quaternion rotationY(T angle);
+
+    /**
+     * Create a rotation around the z-axis
+     *
+     * @param angle   The angle (in radians)
+     * @return        The rotation
+     */
+    static Quaternion rotationZ(T angle);
+
+    /**
+     * Get the real part (i.e., w)
+     */
+    constexpr T getW() const;
+
+    /**
+     * Get the i part (i.e., x)
+     */
+    constexpr T getX() const;
+
+    /**
+     * Get the j part (i.e., y)
+     */
+    constexpr T getY() const;
+
+    /**
+     * Get the k part (i.e., z)
+     */
+    constexpr T getZ() const;
+
+    /**
+     * Get the conjugate of this quaternion (which, for a unit quaternion,
+     * is the inverse rotation)
+     *
+     * @return   w - xi - yj - zk
+     */
+    constexpr Quaternion conjugate() const;
+
+    /**
+     * Rotate a point (or direction) by this (unit) quaternion
+     *
+     * @param v   The point
+     * @return    The rotated point
+     */
+    constexpr Matrix<3,1,T> rotate(const Matrix<3,1,T>& v) const;
+
+    /**
+     * Get the 4x4 Matrix of the rotation represented by this (unit)
+     * quaternion
+     *
+     * @return   The Matrix
+     */
+    constexpr Matrix<4,4,T> toMatrix() const;
+
+    /**
+     * Get the AffineTransform of the rotation represented by this (unit)
+     * quaternion
+     *
+     * @return   The AffineTransform
+     */
+    constexpr AffineTransform<T> toAffine() const;
+
+    /**
+     * Compose two rotations (i.e., a * b applies b and then a)
+     */
+    template <class U>
+    friend constexpr Quaternion<U> operator*(const Quaternion<U>& a, const Quaternion<U>& b);
+
+    /**
+     * Calculate the norm of a quaternion
+     */
+    template <class U>
+    friend U norm(const Quaternion<U>& a);
+
+    /**
+     * Calculate the normalized version of a quaternion
+     */
+    template <class U>
+    friend Quaternion<U> normalized(const Quaternion<U>& a);
+
+    /**
+     * Calculate the dot product of two quaternions
+     */
+    template <class U>
+    friend constexpr U dot(const Quaternion<U>& a, const Quaternion<U>& b);
+
+    /**
+     * Interpolate between two rotations
+     */
+    template <class U>
+    friend Quaternion<U> slerp(const Quaternion<U>& a, const Quaternion<U>& b,
+                               typename MatrixScalar<U>::type t);
+
+    template <class U>
+    friend constexpr bool operator==(const Quaternion<U>& a, const Quaternion<U>& b);
+};
+
+
+
+// Templates
+
+/**
+ * Construct the identity rotation (i.e., 1 + 0i + 0j + 0k)
+ */
+template <class T>
+constexpr Quaternion<T>::Quaternion()
+    : w(1), x(0), y(0), z(0)
+{
+}
+
+
+/**
+ * Construct the quaternion w + xi + yj + zk
+ *
+ * @param w   The real part
+ * @param x   The i part
+ * @param y   The j part
+ * @param z   The k part
+ */
+template <class T>
+constexpr Quaternion<T>::Quaternion(T w, T x, T y, T z)
+    : w(w), x(x), y(y), z(z)
+{
+}
+
+
+/**
+ * Create a rotation around an axis
+ *
+ * @param axis    The axis (which need not be normalized)
+ * @param angle   The angle (in radians)
+ * @throws        domain_error if the axis is 0
+ * @return        The rotation
+ */
+template <class T>
+Quaternion<T> Quaternion<T>::fromAxisAngle(const Matrix<3,1,T>& axis, T angle)
+{
+    T length = sqrt(dot(axis, axis));
+
+    // (however short the axis is, it has a direction unless its length
+    // is 0, or so small that dividing by it would overflow)
+    if(length < std::numeric_limits<T>::min())
+        throw std::domain_error("fromAxisAngle: zero axis");
+
+    T s = sin(angle / 2) / length;
+    return Quaternion(cos(angle / 2), axis.get(0,0) * s, axis.get(1,0) * s,
+                      axis.get(2,0) * s);
+}
+
+
+/**
+ * Create a rotation from the rotation in the upper-left 3x3 part of a
+ * 4x4 Matrix (using the largest of w, x, y, and z to avoid dividing by
+ * a small number)
+ *
+ * @param m   The Matrix (which must be a rotation)
+ * @throws    invalid_argument if m has a translation or a projection
+ * @return    The rotation
+ */
+template <class T>
+Quaternion<T> Quaternion<T>::fromMatrix(const Matrix<4,4,T>& m)
+{
+    for(int i = 0; i < 3; ++i)
+    {
+        if(m.get(i,3) != T(0) || m.get(3,i) != T(0))
+            throw std::invalid_argument("fromMatrix: not a rotation");
+    }
+    if(m.get(3,3) != T(1))
+        throw std::invalid_argument("fromMatrix: not a rotation");
+
+    T m00 = m.get(0,0), m01 = m.get(0,1), m02 = m.get(0,2);
+    T m10 = m.get(1,0), m11 = m.get(1,1), m12 = m.get(1,2);
+    T m20 = m.get(2,0), m21 = m.get(2,1), m22 = m.get(2,2);
+    T trace = m00 + m11 + m22;
+    T s;
+
+    if(trace > 0)
+    {
+        s = 2 * sqrt(trace + 1);
+        return Quaternion(s / 4, (m21 - m12) / s, (m02 - m20) / s, (m10 - m01) / s);
+    }
+    else if(m00 > m11 && m00 > m22)
+    {
+        s = 2 * sqrt(1 + m00 - m11 - m22);
+        return Quaternion((m21 - m12) / s, s / 4, (m01 + m10) / s, (m02 + m20) / s);
+    }
+    else if(m11 > m22)
+    {
+        s = 2 * sqrt(1 + m11 - m00 - m22);
+        return Quaternion((m02 - m20) / s, (m01 + m10) / s, s / 4, (m12 + m21) / s);
+    }
+    s = 2 * sqrt(1 + m22 - m00 - m11);
+    return Quaternion((m10 - m01) / s, (m02 + m20) / s, (m12 + m21) / s, s / 4);
+}
+
+
+/**
+ * Create a rotation around the x-axis
+ *
+ * @param angle   The angle (in radians)
+ * @return        The rotation
+ */
+template <class T>
+Quaternion<T> Quaternion<T>::rotationX(T angle)
+{
+    return Quaternion(cos(angle / 2), sin(angle / 2), 0, 0);
+}
+
+
+/**
+ * Create a rotation around the y-axis
+ *
+ * @param angle   The angle (in radians)
+ * @return        The rotation
+ */
+template <class T>
+Quaternion<T> Quaternion<T>::rotationY(T angle)
+{
+    return Quaternion(cos(angle / 2), 0, sin(angle / 2), 0);
+}
+
+
+/**
+ * Create a rotation around the z-axis
+ *
+ * @param angle   The angle (in radians)
+ * @return        The rotation
+ */
+template <class T>
+Quaternion<T> Quaternion<T>::rotationZ(T angle)
+{
+    return Quaternion(cos(angle / 2), 0, 0, sin(angle / 2));
+}
+
+
+template <class T>
+constexpr T Quaternion<T>::getW() const
+{
+    return w;
+}
+
+
+template <class T>
+constexpr T Quaternion<T>::getX() const
+{
+    return x;
+}
+
+
+template <class T>
+constexpr T Quaternion<T>::getY() const
+{
+    return y;
+}
+
+
+template <class T>
+constexpr T Quaternion<T>::getZ() const
+{
+    return z;
+}
+
+
+/**
+ * Get the conjugate of this quaternion (which, for a unit quaternion,
+ * is the inverse rotation)
+ *
+ * @return   w - xi - yj - zk
+ */
+template <class T>
+constexpr Quaternion<T> Quaternion<T>::conjugate() const
+{
+    return Quaternion(w, -x, -y, -z);
+}
+
+
+/**
+ * Rotate a point (or direction) by this (unit) quaternion (i.e.,
+ * v + 2u x (u x v + wv), where u = (x, y, z))
+ *
+ * @param v   The point
+ * @return    The rotated point
+ */
+template <class T>
+constexpr Matrix<3,1,T> Quaternion<T>::rotate(const Matrix<3,1,T>& v) const
+{
+    T vx = v.get(0,0), vy = v.get(1,0), vz = v.get(2,0);
+
+    // t = 2 (u x v)
+    T tx = 2 * (y * vz - z * vy);
+    T ty = 2 * (z * vx - x * vz);
+    T tz = 2 * (x * vy - y * vx);
+
+    return Matrix<3,1,T>({vx + w * tx + (y * tz - z * ty),
+                          vy + w * ty + (z * tx - x * tz),
+                          vz + w * tz + (x * ty - y * tx)});
+}
+
+
+/**
+ * Get the 4x4 Matrix of the rotation represented by this (unit)
+ * quaternion
+ *
+ * @return   The Matrix
+ */
+template <class T>
+constexpr Matrix<4,4,T> Quaternion<T>::toMatrix() const
+{
+    return toAffine().toMatrix();
+}
+
+
+/**
+ * Get the AffineTransform of the rotation represented by this (unit)
+ * quaternion
+ *
+ * @return   The AffineTransform
+ */
+template <class T>
+constexpr AffineTransform<T> Quaternion<T>::toAffine() const
+{
+    T xx = x * x, yy = y * y, zz = z * z;
+    T xy = x * y, xz = x * z, yz = y * z;
+    T wx = w * x, wy = w * y, wz = w * z;
+
+    return AffineTransform<T>(Matrix<3,4,T>({1 - 2 * (yy + zz),     2 * (xy - wz),     2 * (xz + wy), 0,
+                                                 2 * (xy + wz), 1 - 2 * (xx + zz),     2 * (yz - wx), 0,
+                                                 2 * (xz - wy),     2 * (yz + wx), 1 - 2 * (xx + yy), 0}));
+}
+
+
+/**
+ * Compose two rotations (i.e., a * b applies b and then a) using the
+ * Hamilton product
+ *
+ * @param a   The rotation to apply second
+ * @param b   The rotation to apply first
+ * @return    The composition
+ */
+template <class T>
+constexpr Quaternion<T> operator*(const Quaternion<T>& a, const Quaternion<T>& b)
+{
+    return Quaternion<T>(a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+                         a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                         a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                         a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w);
+}
+
+
+/**
+ * Calculate the dot product of two quaternions
+ *
+ * @param a   One quaternion
+ * @param b   The other quaternion
+ * @return    The dot product (of the 4 components)
+ */
+template <class T>
+constexpr T dot(const Quaternion<T>& a, const Quaternion<T>& b)
+{
+    return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+
+/**
+ * Calculate the norm of a quaternion
+ *
+ * @param a   The quaternion
+ * @return    ||a||
+ */
+template <class T>
+T norm(const Quaternion<T>& a)
+{
+    return sqrt(dot(a, a));
+}
+
+
+/**
+ * Calculate the normalized version of a quaternion
+ *
+ * @param a   The quaternion
+ * @throws    domain_error if a is 0
+ * @return    a / ||a||
+ */
+template <class T>
+Quaternion<T> normalized(const Quaternion<T>& a)
+{
+    T n = norm(a);
+
+    if(n < std::numeric_limits<T>::min())
+        throw std::domain_error("normalized: zero quaternion");
+
+    return Quaternion<T>(a.w / n, a.x / n, a.y / n, a.z / n);
+}
+
+
+/**
+ * Interpolate between two rotations along the shorter arc between them
+ * (i.e., spherical linear interpolation). When the rotations are
+ * (nearly) the same, the result is linearly interpolated and
+ * normalized.
+ *
+ * @param a   The rotation at t = 0 (a unit quaternion)
+ * @param b   The rotation at t = 1 (a unit quaternion)
+ * @param t   The parameter (usually in [0,1])
+ * @return    The interpolated rotation
+ */
+template <class T>
+Quaternion<T> slerp(const Quaternion<T>& a, const Quaternion<T>& b,
+                    typename MatrixScalar<T>::type t)
+{
+    T             cosine = dot(a, b);
+    Quaternion<T> c      = b;
+
+    // q and -q are the same rotation, so use the closer one
+    if(cosine < 0)
+    {
+        cosine = -cosine;
+        c      = Quaternion<T>(-b.w, -b.x, -b.y, -b.z);
+    }
+
+    T ka, kb;
+    if(cosine > 1 - T(TOLERANCE))
+    {
+        ka = 1 - t;
+        kb = t;
+    }
+    else
+    {
+        T angle = acos(cosine);
+        T s     = sin(angle);
+        ka = sin((1 - t) * angle) / s;
+        kb = sin(t * angle) / s;
+    }
+
+    Quaternion<T> result(ka * a.w + kb * c.w, ka * a.x + kb * c.x,
+                         ka * a.y + kb * c.y, ka * a.z + kb * c.z);
+    return normalized(result);
+}
+
+
+/**
+ * Determine whether two quaternions are equal (within TOLERANCE)
+ *
+ * Note: q and -q represent the same rotation but are not equal.
+ *
+ * @param a   One quaternion
+ * @param b   The other quaternion
+ * @return    true if they are equal; false otherwise
+ */
+template <class T>
+constexpr bool operator==(const Quaternion<T>& a, const Quaternion<T>& b)
+{
+    const T tolerance = static_cast<T>(TOLERANCE);
+
+    return a.w - b.w <= tolerance && b.w - a.w <= tolerance &&
+           a.x - b.x <= tolerance && b.x - a.x <= tolerance &&
+           a.y - b.y <= tolerance && b.y - a.y <= tolerance &&
+           a.z - b.z <= tolerance && b.z - a.z <= tolerance;
+}
+
+#endif
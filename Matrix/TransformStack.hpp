@@ -0,0 +1,216 @@
+/**
+ * TransformStack template
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __cs_transform_stack_hpp__
+#define __cs_transform_stack_hpp__
+
+#include <stdexcept>
+#include "Matrix.hpp"
+#include "AffineTransform.hpp"
+
+/**
+ * A chain of N 4x4 transformations (e.g., a projection, a translation
+ * and two rotations) and their product, F0 * F1 * ... * F(N-1).
+ *
+ * The partial products F0 * ... * Fi are kept, and changing factor i
+ * only recomputes the partial products from i on. So, the factors that
+ * change most often (e.g., the angle of an orbiting camera) should be
+ * last.
+ *
+ * Example of use:
+ *
+ *   TransformStack<3> view;
+ *   view.set(0, projection);
+ *   view.set(1, AffineTransform<>::translation(tx, ty, tz));
+ *   view.set(2, AffineTransform<>::rotationY(theta));
+ *   v = view.getProduct() * triangle.vertices;
+ *
+ *   // Only recomputes the last product
+ *   view.set(2, AffineTransform<>::rotationY(theta + 0.1));
+ *
+ * Note: The partial products are computed when the product is
+ * requested (not when the factors are set), so setting several factors
+ * costs no more than setting the first of them.
+ */
+template <int N, class T = double>
+class TransformStack
+{
+    static_assert(N > 0, "A TransformStack must have at least one factor");
+
+  private:
+    Matrix<4,4,T>          factors[N];
+    mutable Matrix<4,4,T>  products[N];
+    mutable int            dirty;
+
+  public:
+    /**
+     * Construct a TransformStack in which all of the factors are the
+     * identity
+     */
+    TransformStack();
+
+    /**
+     * Get factor i
+     *
+     * @param i   The index of the factor
+     * @return    The factor
+     * @throws    out_of_range if i is out of bounds
+     */
+    const Matrix<4,4,T>& get(int i) const;
+
+    /**
+     * Get the index of the first factor whose partial product must be
+     * recomputed (N when the product is up to date)
+     *
+     * @return   The index
+     */
+    int getDirty() const;
+
+    /**
+     * Get the product of all of the factors (recomputing only the
+     * partial products that have changed)
+     *
+     * @return   F0 * F1 * ... * F(N-1)
+     */
+    const Matrix<4,4,T>& getProduct() const;
+
+    /**
+     * Set factor i (the partial products are only invalidated if the
+     * factor actually changes)
+     *
+     * @param i        The index of the factor
+     * @param factor   The transformation
+     * @throws         out_of_range if i is out of bounds
+     */
+    void set(int i, const Matrix<4,4,T>& factor);
+
+    /**
+     * Set factor i to an affine transformation
+     *
+     * @param i        The index of the factor
+     * @param factor   The transformation
+     * @throws         out_of_range if i is out of bounds
+     */
+    void set(int i, const AffineTransform<T>& factor);
+};
+
+
+// Templates
+
+/**
+ * Construct a TransformStack in which all of the factors (and so all of
+ * the partial products) are the identity
+ */
+template <int N, class T>
+TransformStack<N,T>::TransformStack()
+    : dirty(N)
+{
+    for (int i = 0; i < N; ++i)
+    {
+        this->factors[i]  = identity<4,T>();
+        this->products[i] = identity<4,T>();
+    }
+}
+
+/**
+ * Get factor i
+ *
+ * @param i   The index of the factor
+ * @return    The factor
+ * @throws    out_of_range if i is out of bounds
+ */
+template <int N, class T>
+const Matrix<4,4,T>& TransformStack<N,T>::get(int i) const
+{
+    if (i < 0 || i >= N)
+        throw std::out_of_range("TransformStack: factor index out of bounds");
+
+    return this->factors[i];
+}
+
+/**
+ * Get the index of the first factor whose partial product must be
+ * recomputed
+ *
+ * @return   The index (N when the product is up to date)
+ */
+template <int N, class T>
+int TransformStack<N,T>::getDirty() const
+{
+    return this->dirty;
+}
+
+/**
+ * Get the product of all of the factors.
+ *
+ * Only the partial products from the first factor that changed on are
+ * recomputed (i.e., N - getDirty() products of 4x4 matrices).
+ *
+ * @return   F0 * F1 * ... * F(N-1)
+ */
+template <int N, class T>
+const Matrix<4,4,T>& TransformStack<N,T>::getProduct() const
+{
+    for (int i = this->dirty; i < N; ++i)
+    {
+        if (i == 0)
+            this->products[0] = this->factors[0];
+        else
+            this->products[i] = this->products[i-1] * this->factors[i];
+    }
+    this->dirty = N;
+
+    return this->products[N-1];
+}
+
+/**
+ * Set factor i.
+ *
+ * Setting a factor to (exactly) its current value doesn't invalidate
+ * anything (so that, for example, a view can set all of its factors
+ * when only one of its parameters changed).
+ *
+ * @param i        The index of the factor
+ * @param factor   The transformation
+ * @throws         out_of_range if i is out of bounds
+ */
+template <int N, class T>
+void TransformStack<N,T>::set(int i, const Matrix<4,4,T>& factor)
+{
+    if (i < 0 || i >= N)
+        throw std::out_of_range("TransformStack: factor index out of bounds");
+
+    // Compare exactly (operator== allows a tolerance, which would drop
+    // small changes, e.g., a small step of an orbiting camera)
+    const T* current = this->factors[i].data();
+    const T* next    = factor.data();
+    bool     changed = false;
+    for (int k = 0; k < 16 && !changed; ++k)
+        changed = (current[k] != next[k]);
+
+    if (!changed)
+        return;
+
+    this->factors[i] = factor;
+    if (i < this->dirty)
+        this->dirty = i;
+}
+
+/**
+ * Set factor i to an affine transformation
+ *
+ * @param i        The index of the factor
+ * @param factor   The transformation
+ * @throws         out_of_range if i is out of bounds
+ */
+template <int N, class T>
+void TransformStack<N,T>::set(int i, const AffineTransform<T>& factor)
+{
+    this->set(i, factor.toMatrix());
+}
+
+#endif
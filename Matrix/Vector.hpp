@@ -15,14 +15,14 @@
 
 // Prototype of the Vector class
 // (so that it can be used in the friend prototypes)
-template<int ROWS> class Vector;
+template<int ROWS, class T = double> class Vector;
 
 // Prototypes of friend functions 
-template<int R>
-double norm(const Matrix<R,1>& a);
+template<int R, class T>
+T norm(const Matrix<R,1,T>& a);
 
-template<int R>
-Matrix<R,1> normalized(const Matrix<R,1>& a);
+template<int R, class T>
+Matrix<R,1,T> normalized(const Matrix<R,1,T>& a);
 
 //  Class declaration
 //
@@ -30,22 +30,38 @@ Matrix<R,1> normalized(const Matrix<R,1>& a);
 // there is a norm<1> that corresponds to Vector<1>, ...
 //
 // The parameters ROWS corresponds to the number of rows in all of the
-// methods/functions that have sizes in common
-template<int ROWS>
-class Vector: public Matrix<ROWS,1>
+// methods/functions that have sizes in common, and TALL corresponds to
+// the type of the elements
+template<int ROWS, class TALL>
+class Vector: public Matrix<ROWS,1,TALL>
 {
   public:
     /**
      * Construct a column vector with ROWS rows
      */
-    Vector<ROWS>();
+    Vector<ROWS,TALL>();
 
     /**
      * Copy a Vector of size ROWS
      *
      * @param original  The Vector to copy
      */
-    Vector<ROWS>(const Vector<ROWS>& original);   
+    Vector<ROWS,TALL>(const Vector<ROWS,TALL>& original);   
+
+    /**
+     * Construct a Vector of size ROWS from its elements, e.g.,
+     * Vector<2> p(x, y) (the number of elements is checked at compile
+     * time)
+     *
+     * @param args   The ROWS elements
+     */
+    template <class... Args, class = typename std::enable_if<
+                  (sizeof...(Args) > 1) &&
+                  MatrixElements<TALL,Args...>::value>::type>
+    constexpr Vector<ROWS,TALL>(Args... args);
+
+    // Allow expressions (see MatrixExpression.hpp) to be assigned to Vectors
+    using Matrix<ROWS,1,TALL>::operator=;
 
     /**
      * Calculate the Euclidean norm of a Vector of size R
@@ -53,8 +69,8 @@ class Vector: public Matrix<ROWS,1>
      * @param a   The Vector
      * @return    ||a||
      */
-    template<int R>
-    friend double norm(const Matrix<R,1>& a);
+    template<int R, class T>
+    friend T norm(const Matrix<R,1,T>& a);
     
     /**
      * Calculate the normalized version of a Vector of size R
@@ -62,8 +78,8 @@ class Vector: public Matrix<ROWS,1>
      * @param a   The Vector
      * @return    a / ||a||
      */
-    template<int R>
-    friend Matrix<R,1> normalized(const Matrix<R,1>& a);
+    template<int R, class T>
+    friend Matrix<R,1,T> normalized(const Matrix<R,1,T>& a);
     
     /**
      * Assign an initializer_list to this Vector of size R
@@ -71,7 +87,7 @@ class Vector: public Matrix<ROWS,1>
      * @param m   The initializer_list containing the values
      * @return    The Vector referred to by this
      */
-    Vector<ROWS>& operator=(std::initializer_list<double> m);
+    Vector<ROWS,TALL>& operator=(std::initializer_list<TALL> m);
     
     /**
      * Assign another Vector of size R to this Vector of size R
@@ -79,7 +95,7 @@ class Vector: public Matrix<ROWS,1>
      * @param other   The Vector to copy
      * @return        The Vector referred to by this
      */
-    Vector<ROWS>& operator=(const Matrix<ROWS,1>& other);
+    Vector<ROWS,TALL>& operator=(const Matrix<ROWS,1,TALL>& other);
 };
 
 
@@ -99,11 +115,10 @@ class Vector: public Matrix<ROWS,1>
 /**
  * Construct a column vector with R rows
  */
-template<int R>
-Vector<R>::Vector()
+template<int R, class T>
+Vector<R,T>::Vector()
 {
-   this->allocateMemory(R, 1);
-   this->setValues(0.0);
+   // The Matrix constructor has already initialized the elements to 0
 }
 
 
@@ -112,28 +127,41 @@ Vector<R>::Vector()
  *
  * @param original  The Vector to copy
  */
-template<int R>
-Vector<R>::Vector(const Vector<R>& original)
+template<int R, class T>
+Vector<R,T>::Vector(const Vector<R,T>& original)
+   : Matrix<R,1,T>(original)
 {
-   this->allocateMemory(R, 1);   
-   this->setValues(original);
 }
 
 
 
+/**
+ * Construct a Vector of size R from its elements
+ *
+ * @param args   The R elements
+ */
+template<int R, class T>
+template <class... Args, class>
+constexpr Vector<R,T>::Vector(Args... args)
+   : Matrix<R,1,T>(args...)
+{
+}
+
+
 /**
  * Calculate the Euclidean norm of a Vector of size R
  *
  * @param a   The Vector
  * @return    ||a||
  */
-template<int R>
-double norm(const Matrix<R,1>& a)
+template<int R, class T>
+T norm(const Matrix<R,1,T>& a)
 {
-    double ret = 0.0;
+    const T* v = a.data();
+    T        ret = T();
 
     for(int i = 0; i < R; ++i)
-        ret += pow(a.get(i,0), 2);
+        ret += v[i] * v[i];
     return sqrt(ret);
 }
 
@@ -144,13 +172,15 @@ double norm(const Matrix<R,1>& a)
  * @param a   The Vector
  * @return    a / ||a||
  */
-template<int R>
-Matrix<R,1> normalized(const Matrix<R,1>& a)
+template<int R, class T>
+Matrix<R,1,T> normalized(const Matrix<R,1,T>& a)
 {
-    Matrix<R,1> ret;
-    double normval = norm(a);
+    Matrix<R,1,T> ret;
+    T        normval = norm(a);
+    const T* v = a.data();
+    T*       out = ret.data();
     for(int i = 0; i < R; ++i)
-        ret(i,0) = a.get(i,0) / normval;
+        out[i] = v[i] / normval;
     return ret;
 }
 
@@ -162,13 +192,13 @@ Matrix<R,1> normalized(const Matrix<R,1>& a)
  * @param m   The initializer_list containing the values
  * @return    The Vector referred to by this
  */
-template<int R>
-Vector<R>& Vector<R>::operator=(std::initializer_list<double> m)
+template<int R, class T>
+Vector<R,T>& Vector<R,T>::operator=(std::initializer_list<T> m)
 {
    if(m.size() != R)
        throw std::length_error("operator=: size is different");
 
-   const double*    values;
+   const T*         values;
    
    values = m.begin();   // Returns a pointer to the first element
    this->setValues(values);
@@ -190,8 +220,8 @@ Vector<R>& Vector<R>::operator=(std::initializer_list<double> m)
  * @param other   The Vector to copy
  * @return        The Vector referred to by this
  */
-template<int R>
-Vector<R>& Vector<R>::operator=(const Matrix<R,1>& other)
+template<int R, class T>
+Vector<R,T>& Vector<R,T>::operator=(const Matrix<R,1,T>& other)
 {
    this->setValues(other);
 
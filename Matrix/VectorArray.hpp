@@ -0,0 +1,549 @@
+/**
+ * VectorArray template
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __cs_vector_array_hpp__
+#define __cs_vector_array_hpp__
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "Matrix.hpp"
+#include "Vector.hpp"
+
+/**
+ * An array of points (or direction vectors) of size N that is stored as
+ * a structure of arrays. That is, component i of every point is stored
+ * contiguously, so the batch operations (e.g., norm(), dot(), and
+ * applying a Matrix) are simple loops over contiguous arrays that the
+ * compiler can vectorize.
+ *
+ * Example of use:
+ *
+ *   VectorArray<4> points(n);
+ *   for(int k = 0; k < n; ++k) points.scatter(k, vertex[k]);
+ *
+ *   VectorArray<4> transformed = view * points;
+ *   Vector<4>      first       = transformed.gather(0);
+ *
+ * Note: The point with index k can be copied to (i.e., gathered) and
+ * from (i.e., scattered) a Vector<N> (or a Matrix<N,1>).
+ */
+template <int N, class T = double>
+class VectorArray
+{
+    static_assert(N > 0, "VectorArray size must be positive");
+
+  private:
+    std::vector<T>  components[N];
+    int             size;
+
+  public:
+    typedef T Scalar;
+
+    /**
+     * Construct an empty array
+     */
+    VectorArray();
+
+    /**
+     * Construct an array of the given number of points (all of which
+     * are 0)
+     *
+     * @param size   The number of points
+     * @throws       invalid_argument if size is negative
+     */
+    explicit VectorArray(int size);
+
+    /**
+     * Get the number of points in this array
+     *
+     * @return   The number of points
+     */
+    int getSize() const;
+
+    /**
+     * Change the number of points in this array (new points are 0)
+     *
+     * @param size   The number of points
+     * @throws       invalid_argument if size is negative
+     */
+    void resize(int size);
+
+    /**
+     * Get a pointer to component i of every point (which are contiguous)
+     *
+     * @param i   The index of the component
+     * @throws    out_of_range if i is out of bounds
+     * @return    The pointer
+     */
+    const T* component(int i) const;
+    T*       component(int i);
+
+    /**
+     * Get component i of the point with index k
+     *
+     * @param i   The index of the component
+     * @param k   The index of the point
+     * @throws    out_of_range if i or k are out of bounds
+     * @return    The value of the component
+     */
+    T get(int i, int k) const;
+
+    /**
+     * Copy the point with index k to a Vector
+     *
+     * @param k   The index of the point
+     * @throws    out_of_range if k is out of bounds
+     * @return    The Vector
+     */
+    Vector<N,T> gather(int k) const;
+
+    /**
+     * Copy the point with index k to an existing Vector (or Matrix)
+     *
+     * @param k   The index of the point
+     * @param v   The Vector
+     * @throws    out_of_range if k is out of bounds
+     */
+    void gather(int k, Matrix<N,1,T>& v) const;
+
+    /**
+     * Copy a Vector (or Matrix) to the point with index k
+     *
+     * @param k   The index of the point
+     * @param v   The Vector
+     * @throws    out_of_range if k is out of bounds
+     */
+    void scatter(int k, const Matrix<N,1,T>& v);
+
+    /**
+     * Add a copy of a Vector (or Matrix) to the end of this array
+     *
+     * @param v   The Vector
+     */
+    void append(const Matrix<N,1,T>& v);
+
+    /**
+     * Calculate the Euclidean norm of every point in an array
+     */
+    template <int R, class U>
+    friend std::vector<U> norm(const VectorArray<R,U>& a);
+
+    /**
+     * Calculate the normalized version of every point in an array
+     */
+    template <int R, class U>
+    friend VectorArray<R,U> normalized(const VectorArray<R,U>& a);
+
+    /**
+     * Calculate the dot product of every pair of points in two arrays
+     */
+    template <int R, class U>
+    friend std::vector<U> dot(const VectorArray<R,U>& a, const VectorArray<R,U>& b);
+
+    /**
+     * Add every pair of points in two arrays
+     */
+    template <int R, class U>
+    friend VectorArray<R,U> operator+(const VectorArray<R,U>& a, const VectorArray<R,U>& b);
+
+    /**
+     * Subtract every pair of points in two arrays
+     */
+    template <int R, class U>
+    friend VectorArray<R,U> operator-(const VectorArray<R,U>& a, const VectorArray<R,U>& b);
+
+    /**
+     * Multiply a scalar and every point in an array
+     */
+    template <int R, class U>
+    friend VectorArray<R,U> operator*(typename MatrixScalar<U>::type k, const VectorArray<R,U>& a);
+
+    /**
+     * Multiply every point in an array and a scalar
+     */
+    template <int R, class U>
+    friend VectorArray<R,U> operator*(const VectorArray<R,U>& a, typename MatrixScalar<U>::type k);
+
+    /**
+     * Multiply a Matrix and every point in an array
+     */
+    template <int R, int C, class U>
+    friend VectorArray<R,U> operator*(const Matrix<R,C,U>& m, const VectorArray<C,U>& a);
+};
+
+
+
+// Templates
+
+/**
+ * Construct an empty array
+ */
+template <int N, class T>
+VectorArray<N,T>::VectorArray()
+    : size(0)
+{
+}
+
+
+/**
+ * Construct an array of the given number of points (all of which
+ * are 0)
+ *
+ * @param size   The number of points
+ * @throws       invalid_argument if size is negative
+ */
+template <int N, class T>
+VectorArray<N,T>::VectorArray(int size)
+    : size(0)
+{
+    resize(size);
+}
+
+
+/**
+ * Get the number of points in this array
+ *
+ * @return   The number of points
+ */
+template <int N, class T>
+int VectorArray<N,T>::getSize() const
+{
+    return size;
+}
+
+
+/**
+ * Change the number of points in this array (new points are 0)
+ *
+ * @param size   The number of points
+ * @throws       invalid_argument if size is negative
+ */
+template <int N, class T>
+void VectorArray<N,T>::resize(int size)
+{
+    if(size < 0)
+        throw std::invalid_argument("resize(int): negative size");
+
+    for(int i = 0; i < N; ++i)
+        components[i].resize(size);
+    this->size = size;
+}
+
+
+/**
+ * Get a pointer to component i of every point (which are contiguous)
+ *
+ * @param i   The index of the component
+ * @throws    out_of_range if i is out of bounds
+ * @return    The pointer
+ */
+template <int N, class T>
+const T* VectorArray<N,T>::component(int i) const
+{
+    if(0 > i || i >= N)
+        throw std::out_of_range("component(int): out of range");
+    return components[i].data();
+}
+
+
+template <int N, class T>
+T* VectorArray<N,T>::component(int i)
+{
+    if(0 > i || i >= N)
+        throw std::out_of_range("component(int): out of range");
+    return components[i].data();
+}
+
+
+/**
+ * Get component i of the point with index k
+ *
+ * @param i   The index of the component
+ * @param k   The index of the point
+ * @throws    out_of_range if i or k are out of bounds
+ * @return    The value of the component
+ */
+template <int N, class T>
+T VectorArray<N,T>::get(int i, int k) const
+{
+    if(0 > k || k >= size)
+        throw std::out_of_range("get(int,int): out of range");
+    return component(i)[k];
+}
+
+
+/**
+ * Copy the point with index k to a Vector
+ *
+ * @param k   The index of the point
+ * @throws    out_of_range if k is out of bounds
+ * @return    The Vector
+ */
+template <int N, class T>
+Vector<N,T> VectorArray<N,T>::gather(int k) const
+{
+    Vector<N,T> v;
+
+    gather(k, v);
+    return v;
+}
+
+
+/**
+ * Copy the point with index k to an existing Vector (or Matrix)
+ *
+ * @param k   The index of the point
+ * @param v   The Vector
+ * @throws    out_of_range if k is out of bounds
+ */
+template <int N, class T>
+void VectorArray<N,T>::gather(int k, Matrix<N,1,T>& v) const
+{
+    if(0 > k || k >= size)
+        throw std::out_of_range("gather(int): out of range");
+
+    T* out = v.data();
+    for(int i = 0; i < N; ++i)
+        out[i] = components[i][k];
+}
+
+
+/**
+ * Copy a Vector (or Matrix) to the point with index k
+ *
+ * @param k   The index of the point
+ * @param v   The Vector
+ * @throws    out_of_range if k is out of bounds
+ */
+template <int N, class T>
+void VectorArray<N,T>::scatter(int k, const Matrix<N,1,T>& v)
+{
+    if(0 > k || k >= size)
+        throw std::out_of_range("scatter(int): out of range");
+
+    const T* in = v.data();
+    for(int i = 0; i < N; ++i)
+        components[i][k] = in[i];
+}
+
+
+/**
+ * Add a copy of a Vector (or Matrix) to the end of this array
+ *
+ * @param v   The Vector
+ */
+template <int N, class T>
+void VectorArray<N,T>::append(const Matrix<N,1,T>& v)
+{
+    const T* in = v.data();
+    for(int i = 0; i < N; ++i)
+        components[i].push_back(in[i]);
+    ++size;
+}
+
+
+/**
+ * Calculate the dot product of every pair of points in two arrays
+ *
+ * @param a   One array
+ * @param b   The other array
+ * @throws    length_error if the arrays have different sizes
+ * @return    The dot products (one per point)
+ */
+template <int R, class T>
+std::vector<T> dot(const VectorArray<R,T>& a, const VectorArray<R,T>& b)
+{
+    if(a.size != b.size)
+        throw std::length_error("dot: sizes are different");
+
+    std::vector<T> result(a.size);
+    T*             out = result.data();
+
+    for(int i = 0; i < R; ++i)
+    {
+        const T* x = a.components[i].data();
+        const T* y = b.components[i].data();
+        for(int k = 0; k < a.size; ++k)
+            out[k] += x[k] * y[k];
+    }
+
+    return result;
+}
+
+
+/**
+ * Calculate the Euclidean norm of every point in an array
+ *
+ * @param a   The array
+ * @return    The norms (one per point)
+ */
+template <int R, class T>
+std::vector<T> norm(const VectorArray<R,T>& a)
+{
+    std::vector<T> result = dot(a, a);
+    T*             out    = result.data();
+
+    for(int k = 0; k < a.size; ++k)
+        out[k] = sqrt(out[k]);
+
+    return result;
+}
+
+
+/**
+ * Calculate the normalized version of every point in an array
+ *
+ * @param a   The array
+ * @return    The array of a[k] / ||a[k]||
+ */
+template <int R, class T>
+VectorArray<R,T> normalized(const VectorArray<R,T>& a)
+{
+    std::vector<T>   norms = norm(a);
+    VectorArray<R,T> result(a.size);
+    const T*         n = norms.data();
+
+    for(int i = 0; i < R; ++i)
+    {
+        const T* x = a.components[i].data();
+        T*       y = result.components[i].data();
+        for(int k = 0; k < a.size; ++k)
+            y[k] = x[k] / n[k];
+    }
+
+    return result;
+}
+
+
+/**
+ * Add every pair of points in two arrays
+ *
+ * @param a   One array
+ * @param b   The other array
+ * @throws    length_error if the arrays have different sizes
+ * @return    The array of a[k] + b[k]
+ */
+template <int R, class T>
+VectorArray<R,T> operator+(const VectorArray<R,T>& a, const VectorArray<R,T>& b)
+{
+    if(a.size != b.size)
+        throw std::length_error("operator+: sizes are different");
+
+    VectorArray<R,T> result(a.size);
+
+    for(int i = 0; i < R; ++i)
+    {
+        const T* x = a.components[i].data();
+        const T* y = b.components[i].data();
+        T*       z = result.components[i].data();
+        for(int k = 0; k < a.size; ++k)
+            z[k] = x[k] + y[k];
+    }
+
+    return result;
+}
+
+
+/**
+ * Subtract every pair of points in two arrays
+ *
+ * @param a   One array
+ * @param b   The other array
+ * @throws    length_error if the arrays have different sizes
+ * @return    The array of a[k] - b[k]
+ */
+template <int R, class T>
+VectorArray<R,T> operator-(const VectorArray<R,T>& a, const VectorArray<R,T>& b)
+{
+    if(a.size != b.size)
+        throw std::length_error("operator-: sizes are different");
+
+    VectorArray<R,T> result(a.size);
+
+    for(int i = 0; i < R; ++i)
+    {
+        const T* x = a.components[i].data();
+        const T* y = b.components[i].data();
+        T*       z = result.components[i].data();
+        for(int k = 0; k < a.size; ++k)
+            z[k] = x[k] - y[k];
+    }
+
+    return result;
+}
+
+
+/**
+ * Multiply a scalar and every point in an array
+ *
+ * @param k   The scalar
+ * @param a   The array
+ * @return    The array of k * a[k]
+ */
+template <int R, class T>
+VectorArray<R,T> operator*(typename MatrixScalar<T>::type k, const VectorArray<R,T>& a)
+{
+    VectorArray<R,T> result(a.size);
+
+    for(int i = 0; i < R; ++i)
+    {
+        const T* x = a.components[i].data();
+        T*       y = result.components[i].data();
+        for(int j = 0; j < a.size; ++j)
+            y[j] = k * x[j];
+    }
+
+    return result;
+}
+
+
+/**
+ * Multiply every point in an array and a scalar
+ *
+ * @param a   The array
+ * @param k   The scalar
+ * @return    The array of a[k] * k
+ */
+template <int R, class T>
+VectorArray<R,T> operator*(const VectorArray<R,T>& a, typename MatrixScalar<T>::type k)
+{
+    return k * a;
+}
+
+
+/**
+ * Multiply a Matrix and every point in an array (e.g., to transform
+ * every vertex of a mesh). Each row of the result is a linear
+ * combination of the components of the array.
+ *
+ * @param m   The R x C Matrix
+ * @param a   The array of points of size C
+ * @return    The array of m * a[k]
+ */
+template <int R, int C, class T>
+VectorArray<R,T> operator*(const Matrix<R,C,T>& m, const VectorArray<C,T>& a)
+{
+    VectorArray<R,T> result(a.size);
+
+    for(int r = 0; r < R; ++r)
+    {
+        const T* coefficients = m.rowPointer(r);
+        T*       y            = result.components[r].data();
+        for(int c = 0; c < C; ++c)
+        {
+            const T  w = coefficients[c];
+            const T* x = a.components[c].data();
+            for(int k = 0; k < a.size; ++k)
+                y[k] += w * x[k];
+        }
+    }
+
+    return result;
+}
+
+#endif
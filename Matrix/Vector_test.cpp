@@ -12,6 +12,7 @@
 #include <gtest/gtest.h>
 
 #include "Vector.hpp"
+#include "VectorArray.hpp"
 
 #define DESC(func, desc) cout << "[ TEST     ] " << func << endl << "[ DESC     ] " << desc << end
 
@@ -153,6 +154,22 @@ TEST_F(VectorUnittest, initializer_invalid)
     EXPECT_THROW((test = {1,2,3,4}), std::length_error);
 }
 
+/**
+ * test the element constructor and assign()
+ * Vector should have the given values
+ */
+TEST_F(VectorUnittest, element_constructor_valid)
+{
+    Vector<3> test(4, 63.341, 3.2415125f);
+
+    EXPECT_EQ(test(0,0), 4);
+    EXPECT_EQ(test(1,0), 63.341);
+    EXPECT_FLOAT_EQ(test(2,0), 3.2415125f);
+
+    test.assign(1, 2, 3);
+    EXPECT_EQ(test(2,0), 3);
+}
+
 /**
  * test operator=(Matrix)
  * should return Vector with size of given matrix's row
@@ -212,3 +229,69 @@ TEST_F(VectorUnittest, operator_assign_invalid)
 
 
 
+
+/**
+ * test VectorArray gather() and scatter()
+ * the points should be stored and returned unchanged
+ */
+TEST_F(VectorUnittest, vector_array_gather_valid)
+{
+    VectorArray<3> points(2);
+    Vector<3>      a, b;
+
+    a = {1, 2, 3};
+    b = {-4, 0.5, 6};
+    points.scatter(0, a);
+    points.scatter(1, b);
+    points.append(a);
+
+    EXPECT_EQ(points.getSize(), 3);
+    EXPECT_EQ(points.gather(1), b);
+    EXPECT_EQ(points.gather(2), a);
+    EXPECT_EQ(points.component(1)[1], 0.5);
+    EXPECT_THROW(points.gather(3), std::out_of_range);
+    EXPECT_THROW(points.scatter(-1, a), std::out_of_range);
+}
+
+/**
+ * test the VectorArray batch operations
+ * they should have the same values as the Vector operations
+ */
+TEST_F(VectorUnittest, vector_array_operations_valid)
+{
+    VectorArray<3> points, others;
+    Vector<3>      a, b;
+
+    for(int k = 0; k < 37; ++k)
+    {
+        a = {k * 0.5, 1.0 - k, 2.0 + k * k};
+        b = {3.0, k * 0.25, -1.0 * k};
+        points.append(a);
+        others.append(b);
+    }
+
+    Matrix<2,3> m({1, 2, 3,
+                   0, -1, 0.5});
+
+    std::vector<double> norms = norm(points);
+    std::vector<double> dots  = dot(points, others);
+    VectorArray<3>      unit  = normalized(points);
+    VectorArray<3>      sum   = points + 2.0 * others;
+    VectorArray<3>      diff  = points - others * 0.5;
+    VectorArray<2>      image = m * points;
+
+    for(int k = 0; k < 37; ++k)
+    {
+        points.gather(k, a);
+        others.gather(k, b);
+
+        EXPECT_DOUBLE_EQ(norms[k], norm(a));
+        EXPECT_DOUBLE_EQ(dots[k], dot(a, b));
+        EXPECT_EQ(unit.gather(k), normalized(a));
+        EXPECT_EQ(sum.gather(k), a + 2.0 * b);
+        EXPECT_EQ(diff.gather(k), a - b * 0.5);
+        EXPECT_EQ(image.gather(k), m * a);
+    }
+
+    EXPECT_THROW(points + VectorArray<3>(2), std::length_error);
+}
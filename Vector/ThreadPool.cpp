@@ -0,0 +1,130 @@
+/**
+ * ThreadPool Implementation
+ *
+ * Purpose: ThreadPool class allows an application to split a
+ *          computation into tasks that are run on several threads.
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#include <stdexcept>
+#include "ThreadPool.h"
+
+#pragma mark - Constructors
+
+ThreadPool::ThreadPool(int threads)
+    : job(NULL), tasks(0), next(0), remaining(0), active(0),
+      generation(0), stopping(false)
+{
+    if(threads < 0)
+        throw std::invalid_argument("Negative number of threads is invalid");
+
+    for(int i = 0; i < threads; ++i)
+        this->workers.push_back(std::thread(&ThreadPool::work, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->started.notify_all();
+
+    for(size_t i = 0; i < this->workers.size(); ++i)
+        this->workers[i].join();
+}
+
+#pragma mark - Access members methods
+
+int ThreadPool::getThreads() const
+{
+    return (int)this->workers.size() + 1;
+}
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool(std::thread::hardware_concurrency() > 1 ?
+                           std::thread::hardware_concurrency() - 1 : 0);
+    return pool;
+}
+
+#pragma mark - Running methods
+
+void ThreadPool::run(int n, const std::function<void(int)>& task)
+{
+    if(n <= 0)
+        return;
+
+    // Only one job runs at a time
+    std::lock_guard<std::mutex> runGuard(this->runLock);
+
+    {
+        // Wait for the workers that are still leaving the previous job
+        // (so that they can't take tasks from this one)
+        std::unique_lock<std::mutex> guard(this->lock);
+        this->finished.wait(guard, [this] { return this->active == 0; });
+
+        this->job       = &task;
+        this->tasks     = n;
+        this->remaining = n;
+        this->next.store(0);
+        ++this->generation;
+    }
+    this->started.notify_all();
+
+    this->runTasks();
+
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->finished.wait(guard, [this] {
+        return this->remaining == 0 && this->active == 0;
+    });
+    this->job = NULL;
+}
+
+#pragma mark - Private methods
+
+void ThreadPool::work()
+{
+    long seen = 0;
+
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> guard(this->lock);
+            this->started.wait(guard, [this, seen] {
+                return this->stopping || this->generation != seen;
+            });
+            if(this->stopping)
+                return;
+            seen = this->generation;
+            ++this->active;
+        }
+        this->runTasks();
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            if(--this->active == 0)
+                this->finished.notify_all();
+        }
+    }
+}
+
+void ThreadPool::runTasks()
+{
+    int done = 0;
+
+    for(int i = this->next.fetch_add(1); i < this->tasks; i = this->next.fetch_add(1))
+    {
+        (*this->job)(i);
+        ++done;
+    }
+
+    if(done > 0)
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->remaining -= done;
+        if(this->remaining == 0)
+            this->finished.notify_all();
+    }
+}
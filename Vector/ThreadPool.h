@@ -0,0 +1,92 @@
+/**
+ * ThreadPool header
+ *
+ * Purpose: ThreadPool class allows an application to split a
+ *          computation into tasks that are run on several threads.
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#ifndef __GR__ThreadPool__
+#define __GR__ThreadPool__
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of worker threads that run the tasks 0, 1, ..., n-1 of
+ * a job. The thread that submits the job also runs tasks, and run()
+ * returns when all of them have finished.
+ *
+ * Note: The tasks can run in any order and on any thread, so a task
+ * should only write to its own part of the result (e.g., its own
+ * element of an array of partial sums), which keeps the result from
+ * depending on the scheduling.
+ *
+ * Note: A task must not throw and must not call run() (on any pool).
+ */
+class ThreadPool
+{
+private:
+    std::vector<std::thread>                  workers;
+    std::mutex                                lock, runLock;
+    std::condition_variable                   started, finished;
+    const std::function<void(int)>*           job;
+    int                                       tasks;
+    std::atomic<int>                          next;
+    int                                       remaining;
+    int                                       active;
+    long                                      generation;
+    bool                                      stopping;
+
+    void work();
+    void runTasks();
+
+public:
+    /**
+     * Construct a pool with the given number of worker threads
+     *
+     * @param threads   The number of worker threads (which may be 0)
+     * @throws          invalid_argument if threads is negative
+     */
+    ThreadPool(int threads);
+
+    /**
+     * Destructor (which stops and joins the worker threads)
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Get the number of threads that run tasks (i.e., the worker threads
+     * and the thread that calls run())
+     *
+     * @return    The number of threads
+     */
+    int getThreads() const;
+
+    /**
+     * Run task(0), task(1), ..., task(n-1) and wait for all of them
+     *
+     * @param n      The number of tasks
+     * @param task   The task
+     */
+    void run(int n, const std::function<void(int)>& task);
+
+    /**
+     * Get the pool that is shared by the whole application (which has
+     * one thread per hardware thread, including the caller)
+     *
+     * @return    The pool
+     */
+    static ThreadPool& shared();
+};
+
+#endif
@@ -11,7 +11,159 @@
  * This work complies with the JMU Honor Code.
  */
 
+#include <algorithm>
+#include <vector>
 #include "Vector.h"
+#include "ThreadPool.h"
+
+#if !defined(VECTOR_NO_SIMD) && defined(__AVX__)
+#define VECTOR_SIMD_AVX
+#include <immintrin.h>
+#endif
+
+#pragma mark - Kernels
+
+// The elements are processed in blocks of CHUNK_SIZE. The reductions
+// (e.g., the dot product) compute a partial result for each block and
+// then add the partial results in order, so the result doesn't depend
+// on whether (or how many) threads are used. Vectors with at least
+// PARALLEL_SIZE elements are processed by the shared ThreadPool.
+static const int CHUNK_SIZE    = 1 << 15;
+static const int PARALLEL_SIZE = 1 << 18;
+
+/**
+ * Run f(first, count) on every block of n elements (on several threads
+ * if n is large enough)
+ *
+ * @param n   The number of elements
+ * @param f   The function to run on each block
+ */
+template <class F>
+static void forEachChunk(int n, const F& f)
+{
+    int chunks = (n + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    if(n < PARALLEL_SIZE)
+    {
+        for(int i = 0; i < chunks; ++i)
+            f(i * CHUNK_SIZE, std::min(CHUNK_SIZE, n - i * CHUNK_SIZE));
+    }
+    else
+    {
+        ThreadPool::shared().run(chunks, [&f, n](int i) {
+            f(i * CHUNK_SIZE, std::min(CHUNK_SIZE, n - i * CHUNK_SIZE));
+        });
+    }
+}
+
+/**
+ * Calculate the dot product of two blocks
+ *
+ * Note: The products are accumulated in sixteen lanes (four AVX
+ * registers) which are added in a fixed order at the end.
+ */
+static double dotKernel(const double* a, const double* b, int n)
+{
+    int    i      = 0;
+    double result = 0.0;
+
+#ifdef VECTOR_SIMD_AVX
+    if(n >= 16)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+        for(; i + 16 <= n; i += 16)
+        {
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(a+i),    _mm256_loadu_pd(b+i)));
+            s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(a+i+4),  _mm256_loadu_pd(b+i+4)));
+            s2 = _mm256_add_pd(s2, _mm256_mul_pd(_mm256_loadu_pd(a+i+8),  _mm256_loadu_pd(b+i+8)));
+            s3 = _mm256_add_pd(s3, _mm256_mul_pd(_mm256_loadu_pd(a+i+12), _mm256_loadu_pd(b+i+12)));
+        }
+        double lanes[4];
+        _mm256_storeu_pd(lanes, _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+        result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+#endif
+    for(; i < n; ++i)
+        result += a[i] * b[i];
+
+    return result;
+}
+
+/**
+ * Calculate c = a + k*b for two blocks
+ */
+static void axpyKernel(double k, const double* a, const double* b, double* c, int n)
+{
+    int i = 0;
+
+#ifdef VECTOR_SIMD_AVX
+    __m256d kk = _mm256_set1_pd(k);
+    for(; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(c+i, _mm256_add_pd(_mm256_loadu_pd(a+i),
+                                            _mm256_mul_pd(kk, _mm256_loadu_pd(b+i))));
+#endif
+    for(; i < n; ++i)
+        c[i] = a[i] + k * b[i];
+}
+
+/**
+ * Calculate c = a + b (or a - b) for two blocks
+ */
+static void addKernel(const double* a, const double* b, double* c, int n, bool subtract)
+{
+    int i = 0;
+
+#ifdef VECTOR_SIMD_AVX
+    for(; i + 4 <= n; i += 4)
+    {
+        __m256d x = _mm256_loadu_pd(a+i), y = _mm256_loadu_pd(b+i);
+        _mm256_storeu_pd(c+i, subtract ? _mm256_sub_pd(x, y) : _mm256_add_pd(x, y));
+    }
+#endif
+    for(; i < n; ++i)
+        c[i] = subtract ? a[i] - b[i] : a[i] + b[i];
+}
+
+/**
+ * Calculate c = a * k (or a / k) for a block
+ */
+static void scaleKernel(const double* a, double k, double* c, int n, bool divide)
+{
+    int i = 0;
+
+#ifdef VECTOR_SIMD_AVX
+    __m256d kk = _mm256_set1_pd(k);
+    for(; i + 4 <= n; i += 4)
+    {
+        __m256d x = _mm256_loadu_pd(a+i);
+        _mm256_storeu_pd(c+i, divide ? _mm256_div_pd(x, kk) : _mm256_mul_pd(x, kk));
+    }
+#endif
+    for(; i < n; ++i)
+        c[i] = divide ? a[i] / k : a[i] * k;
+}
+
+/**
+ * Calculate the dot product of two arrays (in a deterministic order)
+ */
+static double dotProduct(const double* a, const double* b, int n)
+{
+    int    chunks = (n + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    double result = 0.0;
+
+    if(chunks <= 1)
+        return dotKernel(a, b, n);
+
+    std::vector<double> partial(chunks);
+    forEachChunk(n, [&partial, a, b](int first, int count) {
+        partial[first / CHUNK_SIZE] = dotKernel(a + first, b + first, count);
+    });
+    for(int i = 0; i < chunks; ++i)
+        result += partial[i];
+
+    return result;
+}
 
 #pragma mark - Constructors
 
@@ -36,6 +188,26 @@ Vector::Vector(const Vector& original)
     this->setValues(original.values);
 }
 
+Vector::Vector(Vector&& original) noexcept
+{
+    this->size        = original.size;
+    this->orientation = original.orientation;
+    this->ownsValues  = original.ownsValues;
+
+    if(original.values == original.inlineValues)
+    {
+        this->values = this->inlineValues;
+        this->setValues(original.inlineValues);
+    }
+    else
+    {
+        this->values        = original.values;
+        original.values     = original.inlineValues;
+        original.ownsValues = true;
+    }
+    original.size = 0;
+}
+
 Vector::~Vector()
 {
     this->deallocateMemory();
@@ -65,20 +237,19 @@ int Vector::getSize() const
 
 double norm(const Vector& a)
 {
-    double retNorm = 0;
-    
-    for(int i = 0; i < a.size; ++i)
-        retNorm += pow(a.values[i], 2);
-    
-    return sqrt(retNorm);
+    return sqrt(dotProduct(a.values, a.values, a.size));
 }
 
 Vector normalized(const Vector& a)
 {
     Vector normVector(a.size, a.orientation);
     double normVal = norm(a);
-    for(int i = 0; i < a.size; ++i)
-        normVector.values[i] = a.values[i] / normVal;
+    const double* x = a.values;
+    double*       y = normVector.values;
+
+    forEachChunk(a.size, [normVal, x, y](int first, int count) {
+        scaleKernel(x + first, normVal, y + first, count, true);
+    });
     
     return normVector;
 }
@@ -119,6 +290,59 @@ Vector& Vector::operator=(const Vector &other)
     return *this;
 }
 
+Vector& Vector::operator=(Vector&& other)
+{
+    if(this == &other)
+        return *this;
+
+    // A view (see transView()) must match and assigns to the elements
+    // of the original, an empty (e.g., moved from) Vector takes the size
+    // and orientation of other, and any other Vector must match them
+    if(this->size != 0 || !this->ownsValues)
+    {
+        if(this->size != other.size)
+            throw std::length_error("Two vector's length is not same"); // throw exception
+        if(this->orientation != other.orientation)
+            throw std::length_error("Two vector's orientation is not same");
+    }
+
+    if(!this->ownsValues)
+    {
+        this->setValues(other.values);
+        return *this;
+    }
+
+    if(other.ownsValues && other.values != other.inlineValues)
+    {
+        // Take the elements of a large Vector (rather than copying them)
+        this->deallocateMemory();
+        this->values     = other.values;
+        this->ownsValues = true;
+        this->size       = other.size;
+    }
+    else if(this->size != other.size)
+    {
+        this->size = other.size;
+        this->allocateMemory();
+        this->setValues(other.values);
+    }
+    else
+    {
+        this->setValues(other.values);
+    }
+    this->orientation = other.orientation;
+
+    // Leave other empty (like the move constructor), unless it is a view
+    // (whose elements belong to another Vector)
+    if(other.ownsValues)
+    {
+        other.values = other.inlineValues;
+        other.size   = 0;
+    }
+
+    return *this;
+}
+
 Vector operator+(const Vector& a, const Vector& b)
 {
     if(a.size != b.size)
@@ -126,12 +350,16 @@ Vector operator+(const Vector& a, const Vector& b)
     if(a.orientation != b.orientation)
         throw std::length_error("Two vector's orientation is not same");
     
-    Vector *c = new Vector(a.size, a.orientation);
-    
-    for(int i = 0; i < a.size; ++i)
-        c->values[i] = a.values[i] + b.values[i];
+    Vector c(a.size, a.orientation);
+    const double* x = a.values;
+    const double* y = b.values;
+    double*       z = c.values;
+
+    forEachChunk(a.size, [x, y, z](int first, int count) {
+        addKernel(x + first, y + first, z + first, count, false);
+    });
     
-    return *c;
+    return c;
 }
 
 Vector operator-(const Vector& a, const Vector& b)
@@ -141,12 +369,16 @@ Vector operator-(const Vector& a, const Vector& b)
     if(a.orientation != b.orientation)
         throw std::length_error("Two vector's orientation is not same");
     
-    Vector *c = new Vector(a.size, a.orientation);
-    
-    for(int i = 0; i < a.size; ++i)
-        c->values[i] = a.values[i] - b.values[i];
+    Vector c(a.size, a.orientation);
+    const double* x = a.values;
+    const double* y = b.values;
+    double*       z = c.values;
+
+    forEachChunk(a.size, [x, y, z](int first, int count) {
+        addKernel(x + first, y + first, z + first, count, true);
+    });
     
-    return *c;
+    return c;
 }
 
 double operator*(const Vector& a, const Vector& b)
@@ -156,32 +388,33 @@ double operator*(const Vector& a, const Vector& b)
     if(a.orientation != b.orientation)
         throw std::length_error("Two vector's orientation is not same");
     
-    double ret = 0;
-    
-    for(int i = 0; i < a.size; ++i)
-        ret += a.values[i] * b.values[i];
-    
-    return ret;
+    return dotProduct(a.values, b.values, a.size);
 }
 
 Vector operator*(double k, const Vector& a)
 {
-    Vector * retVector = new Vector(a.size, a.orientation);
-    
-    for(int i = 0; i < a.size; ++i)
-        retVector->values[i] = a.values[i] * k;
+    Vector retVector(a.size, a.orientation);
+    const double* x = a.values;
+    double*       y = retVector.values;
+
+    forEachChunk(a.size, [x, k, y](int first, int count) {
+        scaleKernel(x + first, k, y + first, count, false);
+    });
     
-    return *retVector;
+    return retVector;
 }
 
 Vector operator*(const Vector& a, double k)
 {
-    Vector * retVector = new Vector(a.size, a.orientation);
-    
-    for(int i = 0; i < a.size; ++i)
-        retVector->values[i] = a.values[i] * k;
+    Vector retVector(a.size, a.orientation);
+    const double* x = a.values;
+    double*       y = retVector.values;
+
+    forEachChunk(a.size, [x, k, y](int first, int count) {
+        scaleKernel(x + first, k, y + first, count, false);
+    });
     
-    return *retVector;
+    return retVector;
 }
 
 bool operator==(const Vector& a, const Vector& b)
@@ -222,6 +455,21 @@ bool operator!=(const Vector& a, const Vector& b)
     return ret;
 }
 
+void axpy(double k, const Vector& x, Vector& y)
+{
+    if(x.size != y.size)
+        throw std::length_error("Two vector's length is not same"); // throw exception
+    if(x.orientation != y.orientation)
+        throw std::length_error("Two vector's orientation is not same");
+
+    const double* a = x.values;
+    double*       b = y.values;
+
+    forEachChunk(x.size, [k, a, b](int first, int count) {
+        axpyKernel(k, b + first, a + first, b + first, count);
+    });
+}
+
 #pragma mark - Miscellaneous methods
 
 Vector trans(const Vector& a)
@@ -236,6 +484,29 @@ Vector trans(const Vector& a)
     return retVector;
 }
 
+Vector trans(Vector&& a)
+{
+    Vector retVector(std::move(a));
+
+    if(retVector.orientation == Vector::ROW)
+        retVector.orientation = Vector::COLUMN;
+    else
+        retVector.orientation = Vector::ROW;
+
+    return retVector;
+}
+
+Vector transView(Vector& a)
+{
+    Vector retVector(0, a.orientation == Vector::ROW ? Vector::COLUMN : Vector::ROW);
+
+    retVector.size       = a.size;
+    retVector.values     = a.values;
+    retVector.ownsValues = false;
+
+    return retVector;
+}
+
 #pragma mark - Debug helper methods
 
 double * Vector::get_content() const
@@ -258,12 +529,17 @@ double * Vector::get_content() const
 
 void Vector::allocateMemory()
 {
-    this->values = new double[this->size];
+    this->ownsValues = true;
+    if(this->size <= INLINE_SIZE)
+        this->values = this->inlineValues;
+    else
+        this->values = new double[this->size];
 }
 
 void Vector::deallocateMemory()
 {
-    delete[] this->values;
+    if(this->ownsValues && this->values != this->inlineValues)
+        delete[] this->values;
 }
 
 void Vector::setSize(int size, char orientation)
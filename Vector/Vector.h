@@ -23,13 +23,28 @@ using namespace std;
 /**
  * The Vector class is an encapsulation of both n-dimensional
  * points and n-dimensional direction vectors.
+ *
+ * The arithmetic on large Vectors uses AVX (when it is enabled and
+ * VECTOR_NO_SIMD isn't defined) and, for very large ones, several
+ * threads. Sums (e.g., in norm() and the dot product) are always
+ * added in the same order, so the results are reproducible.
  */
 class Vector
 {
 protected:
+    // Vectors with at most INLINE_SIZE elements keep them in
+    // inlineValues (so that they never touch the heap); larger ones
+    // allocate them
+    static const int INLINE_SIZE = 4;
+
     char       orientation;
     double*    values;
     int        size;
+    double     inlineValues[INLINE_SIZE];
+
+    // Whether values belongs to this Vector (rather than to the Vector
+    // that this is a view of)
+    bool       ownsValues;
     
     void allocateMemory();
     void deallocateMemory();
@@ -71,6 +86,17 @@ public:
      * @param original  The Vector to copy
      */
     Vector(const Vector& original);
+
+    /**
+     * A move constructor
+     *
+     * Note: The elements of a large Vector are taken from the original
+     * (rather than copied) and those of a small Vector are copied.
+     * Either way, the original is left empty (i.e., of size 0).
+     *
+     * @param original  The Vector to move
+     */
+    Vector(Vector&& original) noexcept;
     
     /**
      * Destructor
@@ -171,6 +197,23 @@ public:
 	 */
 	Vector& operator=(const Vector& other);
 
+	/**
+	 * Move another Vector into this Vector.
+	 *
+	 * The two Vectors must have the same size and orientation, unless
+	 * this Vector is empty (e.g., it has been moved from), in which case
+	 * it takes the size and orientation of the other one (so that, for
+	 * example, std::swap() works). As with the move constructor, the
+	 * elements of a large Vector are taken (rather than copied) and the
+	 * other Vector is left empty. If this Vector is a view (see
+	 * transView()), the elements are copied into the original instead.
+	 *
+	 * @param other   The right-side Vector
+	 * @throws        length_error if the sizes or orientations don't match
+	 * @return        The Vector referred to by this
+	 */
+	Vector& operator=(Vector&& other);
+
 	/**
 	 * Add the Vector a and the Vector b (component by component)
 	 *
@@ -239,6 +282,19 @@ public:
 	 */
 	friend Vector operator*(const Vector& a, double k);
 
+	/**
+	 * Add a multiple of one Vector to another (i.e., y = y + k*x)
+	 * without creating a temporary
+	 *
+	 * The two Vectors must have the same size and orientation.
+	 *
+	 * @param k   The scalar
+	 * @param x   The Vector to add
+	 * @param y   The Vector to add to
+	 * @throws    length_error if the sizes or orientations don't match
+	 */
+	friend void axpy(double k, const Vector& x, Vector& y);
+
 	/**
 	 * Compare two Vectors to see if they have identical (within a
 	 * pre-defined TOLERANCE) elements
@@ -273,6 +329,34 @@ public:
      * @return    The transposed Vector
      */
     friend Vector trans(const Vector& a);
+
+    /**
+     * Transpose a temporary Vector (e.g., trans(a + b)) without copying
+     * its elements
+     *
+     * @param a   The original Vector
+     * @return    The transposed Vector (which has the elements of a)
+     */
+    friend Vector trans(Vector&& a);
+
+    /**
+     * Create a transposed view of a given Vector. The view has the other
+     * orientation but shares the elements of the original (so nothing is
+     * allocated or copied), and it can be used anywhere a Vector can.
+     *
+     * Example of use:
+     *
+     *   double d = transView(column) * row;
+     *
+     * Note: The view must not outlive the original, and assigning to the
+     * view assigns to the elements of the original (which is why the
+     * original can't be const). Copying the view creates an ordinary
+     * Vector.
+     *
+     * @param a   The original Vector
+     * @return    The transposed view
+     */
+    friend Vector transView(Vector& a);
     
     //debug purpose return double array values
     double * get_content() const;
@@ -289,9 +373,12 @@ Vector operator-(const Vector& a, const Vector& b);
 double operator*(const Vector& a, const Vector& b);
 Vector operator*(double k, const Vector& a);
 Vector operator*(const Vector& a, double k);
+void   axpy(double k, const Vector& x, Vector& y);
 bool   operator==(const Vector& a, const Vector& b);
 bool   operator!=(const Vector& a, const Vector& b);
 Vector trans(const Vector& a);
+Vector trans(Vector&& a);
+Vector transView(Vector& a);
 
 
 #endif 
@@ -0,0 +1,87 @@
+/**
+ * Vector benchmark
+ *
+ * Times arithmetic chains on short and long Vector objects. Along with
+ * the time, it reports the number of heap allocations (and bytes) per
+ * iteration (which should be 0 for the short ones, since their elements
+ * are stored inline). It also times the dot product of long Vectors
+ * (which uses several threads for the longest ones).
+ *
+ * Build with, for example:
+ *
+ *   g++ -std=c++17 -O2 -mavx2 Vector.cpp ThreadPool.cpp Vector_bench.cpp \
+ *       -lbenchmark -lpthread
+ *
+ * Author: Wooyoung Chung
+ *
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "../Matrix/AllocationCounter.h"
+#include "Vector.h"
+
+/**
+ * Create a Vector with distinct, non-trivial elements
+ *
+ * @param size   The size of the Vector
+ * @return       The Vector
+ */
+static Vector sample(int size)
+{
+    Vector v(size);
+
+    for (int i = 1; i <= size; ++i)
+        v(i) = 1.0 + i * 0.75;
+
+    return v;
+}
+
+static void BM_Copy(benchmark::State& state)
+{
+    Vector a = sample(state.range(0));
+
+    AllocationCounter::reset();
+    for (auto _ : state)
+    {
+        Vector b(a);
+        benchmark::DoNotOptimize(b.get_content());
+    }
+    state.counters["allocs/op"] = AllocationCounter::allocations / (double)state.iterations();
+    state.counters["bytes/op"]  = AllocationCounter::bytes / (double)state.iterations();
+}
+BENCHMARK(BM_Copy)->Arg(3)->Arg(4)->Arg(64);
+
+static void BM_Chain(benchmark::State& state)
+{
+    Vector a = sample(state.range(0));
+    Vector b = sample(state.range(0));
+    Vector c = sample(state.range(0));
+    Vector result(state.range(0));
+
+    AllocationCounter::reset();
+    for (auto _ : state)
+    {
+        result = a + b - 2.0 * c;
+        benchmark::DoNotOptimize(result.get_content());
+    }
+    state.counters["allocs/op"] = AllocationCounter::allocations / (double)state.iterations();
+    state.counters["bytes/op"]  = AllocationCounter::bytes / (double)state.iterations();
+}
+BENCHMARK(BM_Chain)->Arg(2)->Arg(3)->Arg(4)->Arg(64);
+
+static void BM_Dot(benchmark::State& state)
+{
+    Vector a = sample(state.range(0));
+    Vector b = sample(state.range(0));
+
+    for (auto _ : state)
+    {
+        double d = a * b;
+        benchmark::DoNotOptimize(d);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 2 * sizeof(double));
+}
+BENCHMARK(BM_Dot)->Arg(1 << 12)->Arg(1 << 17)->Arg(1 << 22)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -652,3 +652,171 @@ TEST(VectorTranspose, ValidInput3) {
 
     EXPECT_TRUE(v1 == v1);
 }
+
+TEST(VectorTranspose, ValidMove) {
+    DESC("friend Vector trans(Vector&& a)", "trans of a temporary should flip the orientation without copying");
+
+    Vector v(6, Vector::ROW);
+    v = { 1, 2, 3, 4, 5, 6 };
+
+    double* content = v.get_content();
+    Vector v1 = trans(std::move(v));
+
+    EXPECT_TRUE(v1.getOrientation() == Vector::COLUMN);
+    EXPECT_TRUE(v1.get_content() == content);
+}
+
+TEST(VectorTransposeView, ValidView) {
+    DESC("friend Vector transView(Vector& a)", "the view should share the elements and have the other orientation");
+
+    Vector v(6, Vector::COLUMN), v1(6, Vector::ROW);
+    v = { 1, 2, 3, 4, 5, 6 };
+    v1 = { 6, 5, 4, 3, 2, 1 };
+
+    Vector view = transView(v);
+    EXPECT_TRUE(view.getOrientation() == Vector::ROW);
+    EXPECT_TRUE(view.get_content() == v.get_content());
+
+    EXPECT_EQ(view * v1, 56);
+    EXPECT_TRUE(view + v1 == trans(v) + v1);
+
+    // Assigning to the view assigns to the original
+    view = { 0, 0, 0, 0, 0, 7 };
+    EXPECT_EQ(v.get(6), 7);
+
+    // (even when a temporary is assigned to it)
+    view = v1 + v1;
+    EXPECT_TRUE(view.get_content() == v.get_content());
+    EXPECT_EQ(v.get(1), 12);
+    EXPECT_THROW(view = v + v, std::length_error);
+
+    Vector small(3, Vector::ROW), small1(3, Vector::COLUMN);
+    small = { 1, 2, 3 };
+    Vector smallView = transView(small);
+    smallView = small1 + small1;
+    EXPECT_TRUE(smallView.get_content() == small.get_content());
+    EXPECT_EQ(small.get(3), 0);
+
+    // Copying the view creates an ordinary Vector
+    Vector copy(view);
+    EXPECT_TRUE(copy.get_content() != v.get_content());
+    EXPECT_TRUE(copy == trans(v));
+}
+
+TEST(VectorMoveConstructorTest, ValidMove) {
+    DESC("Vector(Vector&& original)", "Moving small and large vectors should keep the contents");
+
+    Vector small(3, Vector::COLUMN), large(6, Vector::COLUMN);
+    small = { 1, 2, 3 };
+    large = { 4, 5, 6, 7, 8, 9 };
+
+    double expectedSmall[] = { 1, 2, 3 };
+    double expectedLarge[] = { 4, 5, 6, 7, 8, 9 };
+
+    Vector v(std::move(small));
+    Vector v1(std::move(large));
+
+    EXPECT_TRUE(v.getOrientation() == Vector::COLUMN);
+    EXPECT_TRUE(arrayMatch(expectedSmall, v.get_content()));
+    EXPECT_TRUE(arrayMatch(expectedLarge, v1.get_content()));
+    EXPECT_EQ(large.getSize(), 0);
+}
+
+TEST(VectorMoveAssignOperator, ValidOperator) {
+    DESC("Vector& operator=(Vector&& other)", "Assigning a temporary should be valid for small and large vectors");
+
+    Vector v(2), v1(2), result(2);
+    v = { 1, 2 };
+    v1 = { 3, 4 };
+
+    Vector w(5), w1(5), result1(5);
+    w = { 1, 2, 3, 4, 5 };
+    w1 = { 5, 4, 3, 2, 1 };
+
+    double expected[] = { 7, 10 };
+    double expected1[] = { 11, 10, 9, 8, 7 };
+
+    result = v + 2 * v1;
+    result1 = w + 2 * w1;
+
+    EXPECT_TRUE(arrayMatch(expected, result.get_content()));
+    EXPECT_TRUE(arrayMatch(expected1, result1.get_content()));
+    EXPECT_THROW(result = w + w1, std::length_error);
+
+    // An empty (moved from) Vector takes the size of the temporary
+    Vector moved(std::move(result));
+    EXPECT_EQ(result.getSize(), 0);
+    result = w + w1;
+    EXPECT_EQ(result.getSize(), 5);
+}
+
+TEST(VectorMoveAssignOperator, ValidSwap) {
+    DESC("Vector& operator=(Vector&& other)", "std::swap should exchange small and large vectors");
+
+    Vector small(2), small1(3), large(8), large1(5);
+    small = { 1, 2 };
+    small1 = { 3, 4, 5 };
+    large = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    large1 = { 9, 8, 7, 6, 5 };
+
+    double expectedSmall[] = { 3, 4, 5 };
+    double expectedSmall1[] = { 1, 2 };
+    double expectedLarge[] = { 9, 8, 7, 6, 5 };
+    double expectedLarge1[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    double* content = large.get_content();
+
+    EXPECT_NO_THROW(std::swap(small, small1));
+    EXPECT_NO_THROW(std::swap(large, large1));
+
+    EXPECT_EQ(small.getSize(), 3);
+    EXPECT_EQ(small1.getSize(), 2);
+    EXPECT_TRUE(arrayMatch(expectedSmall, small.get_content()));
+    EXPECT_TRUE(arrayMatch(expectedSmall1, small1.get_content()));
+
+    EXPECT_EQ(large.getSize(), 5);
+    EXPECT_EQ(large1.getSize(), 8);
+    EXPECT_TRUE(arrayMatch(expectedLarge, large.get_content()));
+    EXPECT_TRUE(arrayMatch(expectedLarge1, large1.get_content()));
+    EXPECT_TRUE(large1.get_content() == content);
+}
+
+TEST(VectorLargeOperators, ValidOperators) {
+    DESC("Large vectors", "Operators on vectors that use several threads should match the scalar results");
+
+    int n = 600000;
+    Vector v(n), v1(n);
+    for(int i = 1; i <= n; ++i)
+    {
+        v(i)  = (i % 7) - 3.0;
+        v1(i) = (i % 5) * 0.5;
+    }
+
+    // The elements are small integers (and halves), so the sums are exact
+    double expectedDot = 0, expectedNorm = 0;
+    for(int i = 1; i <= n; ++i)
+    {
+        expectedDot  += v.get(i) * v1.get(i);
+        expectedNorm += v.get(i) * v.get(i);
+    }
+
+    EXPECT_EQ(v * v1, expectedDot);
+    EXPECT_EQ(norm(v), sqrt(expectedNorm));
+
+    Vector sum = v + v1, difference = v - v1, scaled = 2 * v, unit = normalized(v);
+    axpy(2.0, v1, v);
+    for(int i = 1; i <= n; i += 997)
+    {
+        EXPECT_EQ(sum.get(i), v.get(i) - v1.get(i));
+        EXPECT_EQ(difference.get(i), v.get(i) - 3 * v1.get(i));
+        EXPECT_EQ(scaled.get(i), 2 * (v.get(i) - 2 * v1.get(i)));
+        EXPECT_EQ(unit.get(i), (v.get(i) - 2 * v1.get(i)) / sqrt(expectedNorm));
+    }
+}
+
+TEST(VectorAxpy, InvalidInput) {
+    DESC("friend void axpy(double k, const Vector& x, Vector& y)", "Vectors of different sizes should throw exception");
+
+    Vector v(3), v1(4);
+
+    EXPECT_THROW(axpy(2.0, v, v1), std::length_error);
+}